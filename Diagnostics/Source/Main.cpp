@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 6:04:12am
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/Diagnostics.h"
+
+// Headless runner for the developer benchmarks, no host or display needed.
+// editor-paint draws into an offscreen image, so it runs on a bare Linux box
+// too, built from Builds/LinuxMakefile with make CONFIG=Release.
+//
+//   IgnitionDiagnostics accuracy filter
+//   IgnitionDiagnostics instantiation,editor-paint
+//   IgnitionDiagnostics aliasing --csv measurements.csv
+//
+// Without names it runs whatever IGNITION_BENCHMARK lists. --csv names the
+// aliasing suite's output, otherwise IGNITION_ALIASING_CSV does, and the
+// other IGNITION_ variables still pick the capture to replay. Reports go to
+// the JUCE log, and the exit code is 1 if any benchmark failed.
+int main(int argc, char* argv[]) {
+    // The editor's timers and the tables' background build need a message manager
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray names;
+    juce::File aliasingCsv;
+
+    for (int i = 1; i < argc; ++i) {
+        const auto argument = juce::String::fromUTF8(argv[i]);
+
+        if (argument == "--csv" && i + 1 < argc)
+            aliasingCsv = juce::File::getCurrentWorkingDirectory().getChildFile(juce::String::fromUTF8(argv[++i]));
+        else
+            names.addTokens(argument, ",", {});
+    }
+
+    if (names.isEmpty())
+        names.addTokens(juce::SystemStats::getEnvironmentVariable("IGNITION_BENCHMARK", {}), ",", {});
+
+    names.trim();
+    names.removeEmptyStrings();
+
+    if (names.isEmpty()) {
+        std::cerr << "Usage: IgnitionDiagnostics <benchmark>... [--csv <file>]\n"
+                     "  instantiation, editor-paint, filter, accuracy, replay, aliasing\n";
+        return 1;
+    }
+
+    return Diagnostics::runBenchmarks(names, aliasingCsv);
+}
@@ -0,0 +1,1011 @@
+/*
+  ==============================================================================
+
+    AccuracySuite.cpp
+    Created: 19 Oct 2026 7:48:30pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#include "Diagnostics.h"
+
+#if IGNITION_DIAGNOSTICS
+
+#include "PluginProcessor.h"
+
+namespace {
+
+constexpr double sampleRate = 48000.0;
+constexpr int signalLength = 48000;
+constexpr int blockSize = 512;
+
+//=============// TEST SIGNALS //=============//
+struct TestSignal {
+    const char* name;
+    std::vector<float> samples;
+};
+
+std::vector<float> createSweep(double lowest, double highest, double amplitude) {
+    // Exponential sweep, the same time per octave
+    std::vector<float> samples((size_t) signalLength);
+    const double duration = signalLength / sampleRate;
+    const double k = std::log(highest / lowest);
+
+    for (int i = 0; i < signalLength; ++i) {
+        const double t = i / sampleRate;
+        const double phase = juce::MathConstants<double>::twoPi * lowest * duration / k * (std::exp(t * k / duration) - 1.0);
+        samples[(size_t) i] = (float) (amplitude * std::sin(phase));
+    }
+
+    return samples;
+}
+
+std::vector<TestSignal> createTestSignals() {
+    std::vector<TestSignal> signals;
+    juce::Random random(1);
+
+    signals.push_back({ "sweep", createSweep(20.0, 20000.0, 0.89) });
+
+    std::vector<float> noise((size_t) signalLength);
+
+    for (auto& x : noise)
+        x = random.nextFloat() * 2.0f - 1.0f;
+
+    signals.push_back({ "noise", noise });
+
+    // Noise bursts with a 5 ms decay every 100 ms, silence in between
+    std::vector<float> transients((size_t) signalLength);
+
+    for (int i = 0; i < signalLength; ++i) {
+        const int position = i % 4800;
+        const float level = position < 2400 ? std::exp(-(float) position / 240.0f) : 0.0f;
+        transients[(size_t) i] = level * (random.nextFloat() * 2.0f - 1.0f);
+    }
+
+    signals.push_back({ "transients", transients });
+
+    return signals;
+}
+
+//=============// REFERENCES //===============//
+// Straight from the formulas in double, none of the kernels' tricks
+
+const char* const algorithmNames[] = { "Hard Clip", "Tube", "Fuzz", "Rectify", "Downsample", "Diode" };
+
+double referenceDistort(int algorithm, double x, double drive) {
+    auto hardClip = [&](double v) { return juce::jlimit(-1.0, 1.0, v * (drive + 1.0)); };
+
+    switch (algorithm)
+    {
+    case 0:
+        return hardClip(x);
+    case 1:
+        return std::tanh(x * drive) / std::tanh(drive);
+    case 2:
+        return (x < 0.0 ? -1.0 : 1.0) * (1.0 - std::exp(-std::abs(drive * x))) / (1.0 - std::exp(-drive));
+    case 3:
+        return hardClip(std::abs(x));
+    default:
+        return x;
+    }
+}
+
+// Voltage across the diode pair from a source of resistance r, both diodes
+// in, v + 2 r Is sinh(v / Vt) = source solved by Newton
+double referenceDiodeVoltage(double source, double r) {
+    const double vt = DistortionEngine::diodeThermalVoltage;
+    const double rIs = r * DistortionEngine::diodeSaturationCurrent;
+    const double magnitude = std::abs(source);
+
+    // Starting at the smaller of the two asymptotes, Newton comes in from below
+    double v = juce::jmin(magnitude, vt * std::asinh(magnitude / (2.0 * rIs)));
+
+    for (int i = 0; i < 50; ++i) {
+        const double f = v + 2.0 * rIs * std::sinh(v / vt) - magnitude;
+        const double step = f / (1.0 + 2.0 * rIs / vt * std::cosh(v / vt));
+        v -= step;
+
+        if (std::abs(step) < 1.0e-15)
+            break;
+    }
+
+    return std::copysign(v, source);
+}
+
+// The diode clipper as a wave digital filter, like the kernel's, over the
+// same circuit fed the drive alone for its makeup
+std::vector<double> referenceDiodeClipper(const std::vector<float>& input, double drive, double rate) {
+    const double r = DistortionEngine::diodeResistance;
+    const double rc = 1.0 / (2.0 * rate * DistortionEngine::diodeCapacitance);
+    const double rp = r * rc / (r + rc);
+
+    auto step = [&](double source, double& z) {
+        const double v = referenceDiodeVoltage(z + rp / r * (source - z), rp);
+        z = 2.0 * v - z;
+        return v;
+    };
+
+    std::vector<double> output(input.size());
+    double z = 0.0, makeupZ = 0.0;
+
+    for (size_t i = 0; i < input.size(); ++i) {
+        const double v = step(input[i] * drive, z);
+        output[i] = v / step(drive, makeupZ);
+    }
+
+    return output;
+}
+
+// Same steps as DistortionEngine's quantizer
+double referenceQuantizerSteps(double drive) {
+    return juce::jmax(4.0, std::round(64.0 - (drive / 20.0) * 60.0));
+}
+
+double referenceQuantize(float x, double numSteps) {
+    // The product is rounded to float first, like the kernel's, so a tie
+    // can't land on the other side
+    return std::round((double) (x * (float) numSteps)) / numSteps;
+}
+
+double referenceChebyshev(const float* coefficients, int numCoefficients, double x) {
+    // T_k(x) = cos(k acos(x)), summed directly
+    const double angle = std::acos(juce::jlimit(-1.0, 1.0, x));
+    double sum = 0.0;
+
+    for (int k = 0; k < numCoefficients; ++k)
+        sum += coefficients[k] * std::cos(k * angle);
+
+    return sum;
+}
+
+std::vector<double> referenceEnvelope(const std::vector<float>& input, double attackTime, double releaseTime, double gate) {
+    const double attackCoef = std::exp(-std::log(9.0) / (attackTime * sampleRate));
+    const double releaseCoef = std::exp(-std::log(9.0) / (releaseTime * sampleRate));
+
+    std::vector<double> output(input.size());
+    double envelope = 0.0;
+
+    for (size_t i = 0; i < input.size(); ++i) {
+        const double x = std::abs((double) input[i]);
+        const double coef = (x > envelope && x > gate) ? attackCoef : releaseCoef;
+
+        envelope = coef * envelope + (1.0 - coef) * x;
+        output[i] = envelope;
+    }
+
+    return output;
+}
+
+std::vector<double> referenceLowpass(const std::vector<float>& input, const std::vector<float>& cutoff, double resonance) {
+    const double R2 = 1.0 / resonance;
+    std::vector<double> output(input.size());
+    double s1 = 0.0, s2 = 0.0;
+
+    for (size_t i = 0; i < input.size(); ++i) {
+        const double g = std::tan(juce::MathConstants<double>::pi * cutoff[i] / sampleRate);
+        const double h = 1.0 / (1.0 + g * (g + R2));
+
+        const double yHP = h * (input[i] - s1 * (g + R2) - s2);
+        const double yBP = yHP * g + s1;
+        s1 = yHP * g + yBP;
+
+        const double yLP = yBP * g + s2;
+        s2 = yBP * g + yLP;
+
+        output[i] = yLP;
+    }
+
+    return output;
+}
+
+// The mean of the curve between the last input and this one, which is what
+// first order antiderivative anti-aliasing works out in closed form. Integrated
+// with Gauss-Legendre in short pieces, split where a curve has a corner.
+double referenceAntiderivative(int algorithm, double x0, double x1, double drive) {
+    if (x0 == x1)
+        return referenceDistort(algorithm, x0, drive);
+
+    const double nodes[] = { 0.0, -0.5384693101056831, 0.5384693101056831, -0.9061798459386640, 0.9061798459386640 };
+    const double weights[] = { 0.5688888888888889, 0.4786286704993665, 0.4786286704993665, 0.2369268850561891, 0.2369268850561891 };
+
+    const double lowest = juce::jmin(x0, x1), highest = juce::jmax(x0, x1);
+    const double corner = 1.0 / (drive + 1.0);
+    std::vector<double> edges { lowest };
+
+    for (double edge : { -corner, 0.0, corner })
+        if (edge > lowest && edge < highest)
+            edges.push_back(edge);
+
+    edges.push_back(highest);
+
+    double integral = 0.0;
+
+    for (size_t piece = 0; piece + 1 < edges.size(); ++piece) {
+        const double length = edges[piece + 1] - edges[piece];
+        const int numParts = juce::jmax(1, (int) std::ceil(length * (drive + 1.0) * 2.0));
+        const double halfWidth = 0.5 * length / numParts;
+
+        for (int part = 0; part < numParts; ++part) {
+            const double centre = edges[piece] + (2 * part + 1) * halfWidth;
+
+            for (int i = 0; i < 5; ++i)
+                integral += weights[i] * halfWidth * referenceDistort(algorithm, centre + nodes[i] * halfWidth, drive);
+        }
+    }
+
+    return integral / (highest - lowest);
+}
+
+// Chebyshev interpolation of the curve at degree + 1 nodes
+std::vector<float> referencePolynomialFit(int algorithm, int degree, double drive) {
+    const int numNodes = degree + 1;
+    std::vector<float> coefficients((size_t) numNodes);
+
+    for (int k = 0; k < numNodes; ++k) {
+        double sum = 0.0;
+
+        for (int j = 0; j < numNodes; ++j) {
+            const double theta = juce::MathConstants<double>::pi * (j + 0.5) / numNodes;
+            sum += referenceDistort(algorithm, std::cos(theta), drive) * std::cos(k * theta);
+        }
+
+        coefficients[(size_t) k] = (float) (sum * (k == 0 ? 1.0 : 2.0) / numNodes);
+    }
+
+    return coefficients;
+}
+
+// tanh in front of both integrators, each sample solved by bisection until it
+// stops moving rather than for a fixed number of steps
+std::vector<double> referenceSaturatingLowpass(const std::vector<float>& input, const std::vector<float>& cutoff, double resonance) {
+    const double R2 = 1.0 / resonance;
+    std::vector<double> output(input.size());
+    double s1 = 0.0, s2 = 0.0;
+
+    for (size_t i = 0; i < input.size(); ++i) {
+        const double g = std::tan(juce::MathConstants<double>::pi * cutoff[i] / sampleRate);
+
+        // f(bp) = bp - s1 - g tanh(x - R2 bp - s2 - g tanh(bp)) only ever rises,
+        // and has its root within g of s1
+        auto f = [&](double bp) { return bp - s1 - g * std::tanh(input[i] - R2 * bp - s2 - g * std::tanh(bp)); };
+
+        double low = s1 - g, high = s1 + g;
+
+        for (int iteration = 0; iteration < 100 && high - low > 1.0e-15; ++iteration) {
+            const double middle = 0.5 * (low + high);
+            (f(middle) < 0.0 ? low : high) = middle;
+        }
+
+        const double bp = 0.5 * (low + high);
+        const double lp = s2 + g * std::tanh(bp);
+
+        s1 = 2.0 * bp - s1;
+        s2 = 2.0 * lp - s2;
+
+        output[i] = lp;
+    }
+
+    return output;
+}
+
+//=============// COMPARISON //===============//
+struct Metrics {
+    double maxAbsError = 0.0;
+    double snr = 300.0;       // dB, reference power over error power
+    double nullDepth = -300.0; // dBFS, level of what's left after subtracting the reference
+};
+
+struct Tolerance {
+    double maxAbsError;
+    double minSnr;
+    double maxNullDepth;
+};
+
+Metrics compare(const float* actual, const double* reference, int numSamples) {
+    double errorPower = 0.0, referencePower = 0.0;
+    Metrics metrics;
+
+    for (int i = 0; i < numSamples; ++i) {
+        // A NaN would slip past every comparison below, so it counts as infinitely wrong
+        const double error = std::isfinite(actual[i]) ? (double) actual[i] - reference[i]
+                                                      : std::numeric_limits<double>::infinity();
+
+        metrics.maxAbsError = juce::jmax(metrics.maxAbsError, std::abs(error));
+        errorPower += error * error;
+        referencePower += reference[i] * reference[i];
+    }
+
+    if (errorPower > 0.0) {
+        metrics.snr = juce::jmin(300.0, 10.0 * std::log10(referencePower / errorPower));
+        metrics.nullDepth = juce::jmax(-300.0, 10.0 * std::log10(errorPower / numSamples));
+    }
+
+    return metrics;
+}
+
+// Worst case of one path over every signal and setting it was run with
+struct PathResult {
+    juce::String name;
+    Tolerance tolerance;
+    Metrics worst;
+    juce::String worstCase;
+    int numCases = 0;
+    bool passed = true;
+
+    void add(const Metrics& metrics, const juce::String& caseName) {
+        if (numCases == 0 || metrics.snr < worst.snr)
+            worstCase = caseName;
+
+        worst.maxAbsError = juce::jmax(worst.maxAbsError, metrics.maxAbsError);
+        worst.snr = juce::jmin(worst.snr, metrics.snr);
+        worst.nullDepth = juce::jmax(worst.nullDepth, metrics.nullDepth);
+        ++numCases;
+
+        passed = passed && metrics.maxAbsError <= tolerance.maxAbsError
+                        && metrics.snr >= tolerance.minSnr
+                        && metrics.nullDepth <= tolerance.maxNullDepth;
+    }
+
+    juce::String describe() const {
+        return juce::String(passed ? "  PASS " : "  FAIL ") + name + " (" + juce::String(numCases) + " cases): max "
+             + juce::String(worst.maxAbsError, 8) + ", SNR " + juce::String(worst.snr, 1) + " dB, null "
+             + juce::String(worst.nullDepth, 1) + " dBFS, worst " + worstCase + "\n";
+    }
+};
+
+//=============// KERNEL PATHS //=============//
+void testKernels(const DSPKernels::KernelTable& kernels, const std::vector<TestSignal>& signals, std::vector<PathResult>& results) {
+    const juce::String isa = kernels.name;
+    const float drives[] = { 0.01f, 1.0f, 5.0f, 20.0f };
+
+    std::vector<float> data((size_t) signalLength), drive((size_t) signalLength);
+    std::vector<double> reference((size_t) signalLength);
+
+    // Exact curves should be float rounding away from the reference, Fuzz at
+    // the lowest drive loses a little more to 1 - exp(-drive). The fast ones
+    // are allowed what their approximations cost.
+    for (int algorithm = 0; algorithm < 4; ++algorithm) {
+        for (bool exact : { true, false }) {
+            // Hard Clip and Rectify have no approximations, the fast path is the same code
+            if (!exact && (algorithm == 0 || algorithm == 3))
+                continue;
+
+            const Tolerance exactTolerance { 1.0e-5, algorithm == 2 ? 90.0 : 100.0, -105.0 };
+
+            PathResult result { "distort " + isa + " " + algorithmNames[algorithm] + (exact ? " exact" : " fast"),
+                                exact ? exactTolerance : Tolerance { 5.0e-4, 65.0, -70.0 } };
+
+            for (float d : drives) {
+                for (const auto& signal : signals) {
+                    std::copy(signal.samples.begin(), signal.samples.end(), data.begin());
+                    std::fill(drive.begin(), drive.end(), d);
+
+                    kernels.distort(algorithm, exact, data.data(), drive.data(), signalLength);
+
+                    for (int i = 0; i < signalLength; ++i)
+                        reference[(size_t) i] = referenceDistort(algorithm, signal.samples[(size_t) i], d);
+
+                    result.add(compare(data.data(), reference.data(), signalLength), juce::String(signal.name) + " at drive " + juce::String(d, 2));
+                }
+            }
+
+            results.push_back(result);
+        }
+    }
+
+    // The Eco tier's tables, Tube and Fuzz only
+    juce::SharedResourcePointer<DSPTables> tables;
+
+    while (!tables->isReady())
+        juce::Thread::sleep(1);
+
+    for (int algorithm : { 1, 2 }) {
+        PathResult result { "distort " + isa + " " + algorithmNames[algorithm] + " table", { 1.0e-3, 55.0, -60.0 } };
+
+        for (float d : drives) {
+            for (const auto& signal : signals) {
+                std::copy(signal.samples.begin(), signal.samples.end(), data.begin());
+                std::fill(drive.begin(), drive.end(), d);
+
+                kernels.distortTable(algorithm, *tables->getShaperTables(), data.data(), drive.data(), signalLength);
+
+                for (int i = 0; i < signalLength; ++i)
+                    reference[(size_t) i] = referenceDistort(algorithm, signal.samples[(size_t) i], d);
+
+                result.add(compare(data.data(), reference.data(), signalLength), juce::String(signal.name) + " at drive " + juce::String(d, 2));
+            }
+        }
+
+        results.push_back(result);
+    }
+
+    PathResult quantize { "quantize " + isa, { 1.0e-6, 100.0, -120.0 } };
+
+    for (float d : drives) {
+        const double numSteps = referenceQuantizerSteps(d);
+
+        for (const auto& signal : signals) {
+            std::copy(signal.samples.begin(), signal.samples.end(), data.begin());
+
+            kernels.quantize(data.data(), (float) numSteps, 1.0f / (float) numSteps, signalLength);
+
+            for (int i = 0; i < signalLength; ++i)
+                reference[(size_t) i] = referenceQuantize(signal.samples[(size_t) i], numSteps);
+
+            quantize.add(compare(data.data(), reference.data(), signalLength), juce::String(signal.name) + " at " + juce::String((int) numSteps) + " steps");
+        }
+    }
+
+    results.push_back(quantize);
+
+    // Every lane count the engine calls it with, a different signal in each lane.
+    // Besides float rounding the kernel leaves the reverse biased diode out and
+    // stops omega after one Halley step, the reference does neither.
+    const int diodeLaneCounts[] = { 1, 2, kernels.laneGroupSize };
+    const auto circuit = DistortionEngine::getDiodeClipper(sampleRate);
+
+    for (int numLanes : diodeLaneCounts) {
+        PathResult result { "diode clipper " + isa + " " + juce::String(numLanes) + " lanes", { 2.0e-4, 75.0, -85.0 } };
+        std::vector<float> frames((size_t) (signalLength * numLanes)), driveFrames((size_t) (signalLength * numLanes));
+
+        for (float d : drives) {
+            std::vector<float> state((size_t) (2 * numLanes), 0.0f);
+
+            for (int i = 0; i < signalLength * numLanes; ++i) {
+                frames[(size_t) i] = signals[(size_t) (i % numLanes) % signals.size()].samples[(size_t) (i / numLanes)];
+                driveFrames[(size_t) i] = d;
+            }
+
+            kernels.diodeClipper(circuit, state.data(), frames.data(), driveFrames.data(), numLanes, signalLength);
+
+            for (int lane = 0; lane < numLanes; ++lane) {
+                const auto& signal = signals[(size_t) lane % signals.size()];
+                const auto expected = referenceDiodeClipper(signal.samples, d, sampleRate);
+
+                for (int i = 0; i < signalLength; ++i)
+                    data[(size_t) i] = frames[(size_t) (i * numLanes + lane)];
+
+                result.add(compare(data.data(), expected.data(), signalLength),
+                           juce::String(signal.name) + " at drive " + juce::String(d, 2) + ", lane " + juce::String(lane));
+            }
+        }
+
+        results.push_back(result);
+    }
+
+    // Two made up series with decaying coefficients on alternate samples, like
+    // mid/side lanes, at every degree the polynomial shaping uses. The noise
+    // goes past full scale so the clamp gets exercised too.
+    PathResult chebyshev { "chebyshev " + isa, { 1.0e-5, 100.0, -105.0 } };
+    float evenCoefficients[DSPKernels::maxChebyshevCoefficients], oddCoefficients[DSPKernels::maxChebyshevCoefficients];
+
+    for (int k = 0; k < DSPKernels::maxChebyshevCoefficients; ++k) {
+        evenCoefficients[k] = (k % 2 == 1 ? 1.0f : 0.1f) / (float) (k + 1);
+        oddCoefficients[k] = (k % 3 == 0 ? -0.5f : 0.3f) / (float) (k * k + 1);
+    }
+
+    for (int numCoefficients : { 2, 4, 8, 16 }) {
+        for (const auto& signal : signals) {
+            for (int i = 0; i < signalLength; ++i)
+                data[(size_t) i] = signal.samples[(size_t) i] * 1.2f;
+
+            kernels.chebyshev(evenCoefficients, oddCoefficients, numCoefficients, data.data(), signalLength);
+
+            for (int i = 0; i < signalLength; ++i)
+                reference[(size_t) i] = referenceChebyshev(i % 2 == 0 ? evenCoefficients : oddCoefficients, numCoefficients,
+                                                           signal.samples[(size_t) i] * 1.2f);
+
+            chebyshev.add(compare(data.data(), reference.data(), signalLength), juce::String(signal.name) + " at degree " + juce::String(numCoefficients - 1));
+        }
+    }
+
+    results.push_back(chebyshev);
+
+    // The envelope follower's defaults, with and without a gate. Half a second
+    // of release is tens of thousands of float steps, each one rounded.
+    PathResult envelope { "envelope " + isa, { 5.0e-5, 85.0, -95.0 } };
+    const float attackTime = 0.001f, releaseTime = 0.5f;
+    const float attackCoef = std::exp(-std::log(9.0f) / (attackTime * (float) sampleRate));
+    const float releaseCoef = std::exp(-std::log(9.0f) / (releaseTime * (float) sampleRate));
+
+    for (float gate : { 0.0f, 0.1f }) {
+        for (const auto& signal : signals) {
+            const float* channels[] = { signal.samples.data() };
+
+            kernels.envelope(channels, 1, data.data(), signalLength, 0.0f, attackCoef, releaseCoef, gate);
+
+            const auto expected = referenceEnvelope(signal.samples, attackTime, releaseTime, gate);
+            envelope.add(compare(data.data(), expected.data(), signalLength), juce::String(signal.name) + " with gate " + juce::String(gate, 1));
+        }
+    }
+
+    results.push_back(envelope);
+}
+
+//=============// FILTER PATHS //=============//
+void testFilter(const std::vector<TestSignal>& signals, std::vector<PathResult>& results) {
+    const auto& kernels = DSPKernels::getKernels(DSPKernels::selectInstructionSet());
+
+    // Cutoff swept between 200 Hz and 8 kHz twice a second
+    std::vector<float> cutoff((size_t) signalLength);
+
+    for (int i = 0; i < signalLength; ++i)
+        cutoff[(size_t) i] = (float) (200.0 * std::pow(40.0, 0.5 + 0.5 * std::sin(juce::MathConstants<double>::twoPi * 2.0 * i / sampleRate)));
+
+    // Control rate coefficients are expected to drift, but not by much at this sweep speed
+    for (int interval : { 1, 8 }) {
+        PathResult result { "filter per " + juce::String(interval) + (interval == 1 ? " sample" : " samples"),
+                            interval == 1 ? Tolerance { 1.0e-4, 100.0, -110.0 } : Tolerance { 0.1, 38.0, -40.0 } };
+
+        for (float resonance : { 0.707f, 4.0f }) {
+            for (const auto& signal : signals) {
+                StateVariableFilter filter;
+                filter.prepare({ sampleRate, (juce::uint32) blockSize, 1 });
+                filter.setKernels(kernels);
+                filter.setResonance(resonance);
+                filter.setCoefficientInterval(interval);
+
+                std::vector<float> data = signal.samples;
+                std::vector<float> g((size_t) blockSize), h((size_t) blockSize);
+
+                for (int start = 0; start < signalLength; start += blockSize) {
+                    const int n = juce::jmin(blockSize, signalLength - start);
+
+                    filter.computeCoefficients(cutoff.data() + start, g.data(), h.data(), n);
+                    filter.process(0, data.data() + start, g.data(), h.data(), n);
+                }
+
+                const auto expected = referenceLowpass(signal.samples, cutoff, resonance);
+                result.add(compare(data.data(), expected.data(), signalLength), juce::String(signal.name) + " at resonance " + juce::String(resonance, 2));
+            }
+        }
+
+        results.push_back(result);
+    }
+
+    // The update grid carries across blocks, so small or ragged host blocks land
+    // on the same coefficients as whole ones
+    {
+        PathResult result { "filter per 8 samples across host blocks", Tolerance { 1.0e-6, 120.0, -130.0 } };
+
+        // maxBlock 0 runs whole blocks
+        auto run = [&](const std::vector<float>& samples, int maxBlock) {
+            StateVariableFilter filter;
+            filter.prepare({ sampleRate, (juce::uint32) blockSize, 1 });
+            filter.setKernels(kernels);
+            filter.setResonance(2.0f);
+            filter.setCoefficientInterval(8);
+
+            std::vector<float> data = samples;
+            std::vector<float> g((size_t) blockSize), h((size_t) blockSize);
+
+            // Otherwise cycles through every length up to maxBlock, never lining up with the grid for long
+            for (int start = 0, length = 1; start < signalLength; length = length % juce::jmax(1, maxBlock) + 1) {
+                const int n = juce::jmin(maxBlock > 0 ? length : blockSize, signalLength - start);
+
+                filter.computeCoefficients(cutoff.data() + start, g.data(), h.data(), n);
+                filter.process(0, data.data() + start, g.data(), h.data(), n);
+                start += n;
+            }
+
+            return data;
+        };
+
+        for (int maxBlock : { 1, 13 }) {
+            for (const auto& signal : signals) {
+                const auto whole = run(signal.samples, 0);
+                const std::vector<double> expected(whole.begin(), whole.end());
+                const auto split = run(signal.samples, maxBlock);
+
+                result.add(compare(split.data(), expected.data(), signalLength), juce::String(signal.name) + " in blocks up to " + juce::String(maxBlock));
+            }
+        }
+
+        results.push_back(result);
+    }
+
+    // At every tier's iteration cap, and hot enough for the tanh to bite. The
+    // fast tanh and the capped Newton steps are all that separate the two. Any
+    // more resonance and the hot noise turns chaotic, where no two solvers agree.
+    for (int maxIterations : { 2, 4, 8 }) {
+        PathResult result { "saturating filter, " + juce::String(maxIterations) + " steps",
+                            maxIterations == 2 ? Tolerance { 0.1, 45.0, -45.0 } : Tolerance { 0.02, 70.0, -70.0 } };
+
+        for (float level : { 1.0f, 4.0f }) {
+            for (const auto& signal : signals) {
+                StateVariableFilter filter;
+                filter.prepare({ sampleRate, (juce::uint32) blockSize, 1 });
+                filter.setKernels(kernels);
+                filter.setResonance(2.0f);
+                filter.setSaturating(true);
+                filter.setMaxIterations(maxIterations);
+
+                std::vector<float> input = signal.samples;
+
+                for (auto& x : input)
+                    x *= level;
+
+                std::vector<float> data = input;
+                std::vector<float> g((size_t) blockSize), h((size_t) blockSize);
+
+                for (int start = 0; start < signalLength; start += blockSize) {
+                    const int n = juce::jmin(blockSize, signalLength - start);
+
+                    filter.computeCoefficients(cutoff.data() + start, g.data(), h.data(), n);
+                    filter.process(0, data.data() + start, g.data(), h.data(), n);
+                }
+
+                const auto expected = referenceSaturatingLowpass(input, cutoff, 2.0);
+                result.add(compare(data.data(), expected.data(), signalLength), juce::String(signal.name) + " at level " + juce::String(level, 1));
+            }
+        }
+
+        results.push_back(result);
+    }
+}
+
+//=============// ENVELOPE PATHS //=============//
+// Eco's decimated detector, whose groups run across blocks. Small or ragged
+// host blocks should land on the same envelope as whole ones.
+void testEnvelope(const std::vector<TestSignal>& signals, std::vector<PathResult>& results) {
+    PathResult result { "envelope per 8 samples across host blocks", { 1.0e-6, 120.0, -130.0 } };
+
+    // maxBlock 0 runs whole blocks, otherwise every length up to maxBlock in turn
+    auto run = [&](const std::vector<float>& samples, int maxBlock) {
+        EnvelopeFollower follower(0.001f, 0.5f, (float) sampleRate);
+        follower.setGate(0.1f);
+        follower.setDetectorInterval(8);
+
+        std::vector<float> envelope((size_t) signalLength);
+
+        for (int start = 0, length = 1; start < signalLength; length = length % juce::jmax(1, maxBlock) + 1) {
+            const int n = juce::jmin(maxBlock > 0 ? length : blockSize, signalLength - start);
+            const float* channels[] = { samples.data() + start };
+
+            follower.processBlock(channels, 1, envelope.data() + start, n);
+            start += n;
+        }
+
+        return envelope;
+    };
+
+    for (int maxBlock : { 1, 13 }) {
+        for (const auto& signal : signals) {
+            const auto whole = run(signal.samples, 0);
+            const std::vector<double> expected(whole.begin(), whole.end());
+            const auto split = run(signal.samples, maxBlock);
+
+            result.add(compare(split.data(), expected.data(), signalLength), juce::String(signal.name) + " in blocks up to " + juce::String(maxBlock));
+        }
+    }
+
+    results.push_back(result);
+}
+
+//=============// ENGINE PATHS //=============//
+// The drive swings past zero and back, so the clamp in computeDrive is in play
+// for part of every cycle whenever the base drive is low
+void renderEngine(DistortionEngine& engine, std::vector<float>& data, const std::vector<float>& modulation) {
+    std::vector<float> drive((size_t) blockSize);
+
+    for (int start = 0; start < signalLength; start += blockSize) {
+        const int n = juce::jmin(blockSize, signalLength - start);
+
+        engine.computeDrive(modulation.data() + start, drive.data(), n);
+        engine.processBlock(0, data.data() + start, drive.data(), n);
+    }
+}
+
+void testEngine(const std::vector<TestSignal>& signals, std::vector<PathResult>& results) {
+    const auto& kernels = DSPKernels::getKernels(DSPKernels::selectInstructionSet());
+
+    // Still, and swinging 10 either side of the base drive a few times a second
+    std::vector<float> still((size_t) signalLength, 0.0f), swinging((size_t) signalLength);
+
+    for (int i = 0; i < signalLength; ++i)
+        swinging[(size_t) i] = (float) (0.5 * std::sin(juce::MathConstants<double>::twoPi * 3.0 * i / sampleRate));
+
+    auto modulatedDrive = [](float base, float modulation) {
+        return juce::jlimit((double) DistortionEngine::minDrive, (double) DistortionEngine::maxDrive, (double) base + 20.0 * modulation);
+    };
+
+    auto describe = [](int algorithm, const TestSignal& signal, float base, bool swings) {
+        return juce::String(algorithmNames[algorithm]) + ", " + signal.name + " at drive " + juce::String(base, 2)
+             + (swings ? " swinging" : "");
+    };
+
+    // Only the rounding of the result to float, the engine works in double too
+    PathResult antiderivative { "engine antiderivative", { 1.0e-5, 100.0, -110.0 } };
+
+    // The fit is redone every polynomialRefitInterval samples from the drive at the
+    // start, so the reference fits at the same drives
+    PathResult polynomial { "engine polynomial", { 1.0e-4, 85.0, -95.0 } };
+
+    for (int algorithm = 0; algorithm < 4; ++algorithm) {
+        for (float base : { 0.0f, 1.0f, 5.0f }) {
+            for (bool swings : { false, true }) {
+                const auto& modulation = swings ? swinging : still;
+
+                for (const auto& signal : signals) {
+                    DistortionEngine engine;
+                    engine.prepare(1);
+                    engine.setKernels(kernels);
+                    engine.setDistortionAlgorithm(algorithm);
+                    engine.setDrive(base);
+                    engine.setShaping(DistortionEngine::Shaping::antiderivative);
+
+                    std::vector<float> data = signal.samples;
+                    renderEngine(engine, data, modulation);
+
+                    std::vector<double> expected((size_t) signalLength);
+                    float previous = 0.0f;
+
+                    for (int i = 0; i < signalLength; ++i) {
+                        const float x = signal.samples[(size_t) i];
+                        expected[(size_t) i] = referenceAntiderivative(algorithm, previous, x, modulatedDrive(base, modulation[(size_t) i]));
+                        previous = x;
+                    }
+
+                    antiderivative.add(compare(data.data(), expected.data(), signalLength), describe(algorithm, signal, base, swings));
+                }
+
+                for (int degree : { DistortionEngine::getAliasFreeDegree(2), DSPKernels::maxChebyshevCoefficients - 1 }) {
+                    for (const auto& signal : signals) {
+                        DistortionEngine engine;
+                        engine.prepare(1);
+                        engine.setKernels(kernels);
+                        engine.setDistortionAlgorithm(algorithm);
+                        engine.setDrive(base);
+                        engine.setPolynomialDegree(degree);
+                        engine.setShaping(DistortionEngine::Shaping::polynomial);
+
+                        std::vector<float> data = signal.samples;
+                        renderEngine(engine, data, modulation);
+
+                        std::vector<double> expected((size_t) signalLength);
+                        std::vector<float> coefficients;
+
+                        for (int i = 0; i < signalLength; ++i) {
+                            if (i % 32 == 0)
+                                coefficients = referencePolynomialFit(algorithm, degree, modulatedDrive(base, modulation[(size_t) i]));
+
+                            expected[(size_t) i] = referenceChebyshev(coefficients.data(), degree + 1, signal.samples[(size_t) i]);
+                        }
+
+                        polynomial.add(compare(data.data(), expected.data(), signalLength),
+                                       describe(algorithm, signal, base, swings) + ", degree " + juce::String(degree));
+                    }
+                }
+            }
+        }
+    }
+
+    results.push_back(antiderivative);
+    results.push_back(polynomial);
+}
+
+//===========// PROCESSOR PATHS //============//
+void setParameter(IngitionAudioProcessor& processor, const juce::String& id, float value) {
+    auto* parameter = processor.apvts.getParameter(id);
+    jassert(parameter != nullptr);
+
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+// Both channels get the same signal, the output comes back interleaved per channel
+// Runs on past the end by the reported latency and leaves it out, so the
+// output lines up with the input
+std::vector<float> render(IngitionAudioProcessor& processor, const std::vector<float>& input) {
+    const int latency = processor.getLatencySamples();
+    const int length = signalLength + latency;
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midi;
+    std::vector<float> padded((size_t) length, 0.0f), output((size_t) signalLength * 2);
+
+    std::copy(input.begin(), input.begin() + signalLength, padded.begin());
+
+    for (int start = 0; start < length; start += blockSize) {
+        const int n = juce::jmin(blockSize, length - start);
+        buffer.setSize(2, n, false, false, true);
+
+        for (int channel = 0; channel < 2; ++channel)
+            std::copy(padded.begin() + start, padded.begin() + start + n, buffer.getWritePointer(channel));
+
+        processor.processBlock(buffer, midi);
+
+        for (int channel = 0; channel < 2; ++channel)
+            for (int i = juce::jmax(0, latency - start); i < n; ++i)
+                output[(size_t) (channel * signalLength + start + i - latency)] = buffer.getSample(channel, i);
+    }
+
+    return output;
+}
+
+void testProcessor(const std::vector<TestSignal>& signals, std::vector<PathResult>& results) {
+    // The render path needs the real oversampling filters, not the stand in
+    juce::SharedResourcePointer<DSPTables> tables;
+
+    while (!tables->isReady())
+        juce::Thread::sleep(1);
+
+    IngitionAudioProcessor processor;
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    // Everything but the distortion out of the way, and no latency
+    setParameter(processor, "pre-filter on", 0.0f);
+    setParameter(processor, "post-filter on", 0.0f);
+    setParameter(processor, "cabinet on", 0.0f);
+    setParameter(processor, "drive mod", 0.0f);
+    setParameter(processor, "stereo mode", 0.0f);
+    setParameter(processor, "downsample rate", 1.0f);
+    setParameter(processor, "downsample band limit", 0.0f);
+    setParameter(processor, "mix", 1.0f);
+    setParameter(processor, "render quality", 0.0f);
+
+    for (int slot = 1; slot <= 4; ++slot)
+        setParameter(processor, "mod " + juce::String(slot) + " depth", 0.0f);
+
+    // Realtime runs the fast curves, so it's held to the fast tolerance. Diode
+    // has a memory the curves don't, the kernel paths above cover it.
+    for (int algorithm = 0; algorithm < 5; ++algorithm) {
+        PathResult result { juce::String("processor realtime ") + algorithmNames[algorithm], { 5.0e-4, 65.0, -70.0 } };
+        setParameter(processor, "distortion type", (float) algorithm);
+
+        for (float d : { 0.5f, 5.0f, 20.0f }) {
+            setParameter(processor, "drive", d);
+
+            for (const auto& signal : signals) {
+                const auto output = render(processor, signal.samples);
+                std::vector<double> expected((size_t) signalLength);
+
+                for (int i = 0; i < signalLength; ++i)
+                    expected[(size_t) i] = algorithm == 4 ? referenceQuantize(signal.samples[(size_t) i], referenceQuantizerSteps(d))
+                                                          : referenceDistort(algorithm, signal.samples[(size_t) i], d);
+
+                for (int channel = 0; channel < 2; ++channel)
+                    result.add(compare(output.data() + channel * signalLength, expected.data(), signalLength),
+                               juce::String(signal.name) + " at drive " + juce::String(d, 2) + ", channel " + juce::String(channel));
+            }
+        }
+
+        results.push_back(result);
+    }
+
+    // Four LFO routings at full negative depth push the drive far below zero for
+    // half of every cycle. Whatever the tier, the output has to stay finite, within
+    // full scale and, where the curve is memoryless, on the same side as the input.
+    // Diode's capacitor holds on to past samples, so it may cross zero, and its
+    // bilinear capacitor rings a few percent past full scale on hard edges whatever
+    // the drive does. The High tier oversamples, and hard edges ring through the
+    // filters on both sides of zero, so there it only has to stay within twice
+    // full scale.
+    setParameter(processor, "lfo 1 rate", 7.0f);
+    setParameter(processor, "lfo 1 shape", 0.0f);
+
+    for (int slot = 1; slot <= 4; ++slot) {
+        setParameter(processor, "mod " + juce::String(slot) + " source", 1.0f);
+        setParameter(processor, "mod " + juce::String(slot) + " destination", 0.0f);
+        setParameter(processor, "mod " + juce::String(slot) + " depth", -1.0f);
+    }
+
+    for (int tier = 0; tier < QualitySettings::numTiers; ++tier) {
+        PathResult result { "processor negative drive tier " + juce::String(tier), { 1.0e-6, 120.0, -130.0 } };
+        setParameter(processor, "quality tier", (float) tier);
+
+        const bool oversampled = tier == QualitySettings::high;
+
+        for (int algorithm = 0; algorithm < 6; ++algorithm) {
+            setParameter(processor, "distortion type", (float) algorithm);
+
+            for (float d : { 0.01f, 5.0f }) {
+                setParameter(processor, "drive", d);
+
+                for (const auto& signal : signals) {
+                    const auto output = render(processor, signal.samples);
+                    std::vector<double> expected((size_t) signalLength);
+
+                    for (int channel = 0; channel < 2; ++channel) {
+                        const float* y = output.data() + channel * signalLength;
+
+                        for (int i = 0; i < signalLength; ++i) {
+                            const double x = signal.samples[(size_t) i];
+                            const double limit = oversampled ? 2.0 : algorithm == 5 ? 1.1 : 1.0;
+                            double legal = juce::jlimit(-limit, limit, (double) y[i]);
+
+                            const bool sameSide = !oversampled && algorithm != 5;
+
+                            if (sameSide && algorithm == 3)
+                                legal = juce::jmax(0.0, legal);
+                            else if (sameSide && legal * x < 0.0)
+                                legal = 0.0;
+
+                            expected[(size_t) i] = legal;
+                        }
+
+                        result.add(compare(y, expected.data(), signalLength),
+                                   juce::String(algorithmNames[algorithm]) + ", " + signal.name + " at drive "
+                                   + juce::String(d, 2) + ", channel " + juce::String(channel));
+                    }
+                }
+            }
+        }
+
+        results.push_back(result);
+    }
+
+    setParameter(processor, "quality tier", (float) QualitySettings::standard);
+
+    for (int slot = 1; slot <= 4; ++slot)
+        setParameter(processor, "mod " + juce::String(slot) + " depth", 0.0f);
+
+    // Realtime and offline report the same latency, whatever the render quality.
+    // Hard Clip at the lowest drive is a plain gain for a quiet sweep, so with
+    // the reported latency taken out both should null against the input.
+    setParameter(processor, "distortion type", 0.0f);
+    setParameter(processor, "drive", 0.01f);
+    setParameter(processor, "render quality", 1.0f);
+
+    const auto quietSweep = createSweep(20.0, 10000.0, 0.5);
+    const int settle = 256;
+
+    for (bool offline : { false, true }) {
+        processor.setNonRealtime(offline);
+
+        // The realtime path is a pure delay, the offline one goes through the filters
+        PathResult result { offline ? "processor offline latency" : "processor realtime latency",
+                            offline ? Tolerance { 2.0e-4, 80.0, -90.0 } : Tolerance { 1.0e-6, 120.0, -130.0 } };
+
+        // The filters look ahead by half the latency, so the last samples see the
+        // sweep cut off and are left out along with the first
+        const auto output = render(processor, quietSweep);
+        const int length = signalLength - settle - Oversampler::latency;
+        std::vector<double> expected((size_t) length);
+
+        for (int i = 0; i < length; ++i)
+            expected[(size_t) i] = 1.01 * quietSweep[(size_t) (settle + i)];
+
+        for (int channel = 0; channel < 2; ++channel)
+            result.add(compare(output.data() + channel * signalLength + settle, expected.data(), length),
+                       "quiet sweep, channel " + juce::String(channel));
+
+        result.name += " (" + juce::String(processor.getLatencySamples()) + " samples reported)";
+        result.passed = result.passed && processor.getLatencySamples() == Oversampler::latency;
+
+        results.push_back(result);
+    }
+
+    processor.setNonRealtime(false);
+}
+
+} // namespace
+
+juce::String Diagnostics::runAccuracySuite(bool& passed) {
+    const auto signals = createTestSignals();
+    std::vector<PathResult> results;
+
+    for (int i = 0; i < (int) DSPKernels::InstructionSet::numInstructionSets; ++i) {
+        const auto instructionSet = static_cast<DSPKernels::InstructionSet>(i);
+
+        if (DSPKernels::isSupported(instructionSet))
+            testKernels(DSPKernels::getKernels(instructionSet), signals, results);
+    }
+
+    testFilter(signals, results);
+    testEnvelope(signals, results);
+    testEngine(signals, results);
+    testProcessor(signals, results);
+
+    passed = std::all_of(results.begin(), results.end(), [](const PathResult& result) { return result.passed; });
+
+    juce::String report = juce::String("Ignition accuracy suite: ") + (passed ? "passed" : "FAILED") + "\n";
+
+    for (const auto& result : results)
+        report += result.describe();
+
+    return report;
+}
+
+#endif
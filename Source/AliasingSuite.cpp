@@ -0,0 +1,251 @@
+/*
+  ==============================================================================
+
+    AliasingSuite.cpp
+    Created: 19 Oct 2026 11:20:14pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#include "Diagnostics.h"
+
+#if IGNITION_DIAGNOSTICS
+
+#include <algorithm>
+#include <iterator>
+#include "DistortionEngine.h"
+#include "Oversampler.h"
+
+namespace {
+
+constexpr double sampleRate = 48000.0;
+constexpr int fftOrder = 14;
+constexpr int fftSize = 1 << fftOrder;
+constexpr int warmupLength = 4096; // settles the oversampler and the antiderivative state
+constexpr int blockSize = 128;
+
+// Every tone sits on a multiple of this many bins, so every harmonic and
+// intermodulation product of the tones does too. fftSize leaves 5 over when
+// divided by 11, so an image folded back at Nyquist can only land on the grid
+// after folding a multiple of 11 times, far past anything with energy left.
+// On the grid is distortion, off it is aliasing.
+constexpr int gridSpacing = 11;
+
+const char* const algorithmNames[] = { "Hard Clip", "Tube", "Fuzz", "Rectify", "Downsample", "Diode" };
+
+//=============// MODES //====================//
+// Every way the processor can run the curves, cheapest first
+struct Mode {
+    const char* name;
+    DistortionEngine::Shaping shaping;
+    int oversamplingFactor;
+};
+
+const Mode modes[] = {
+    { "table",          DistortionEngine::Shaping::lookupTable,    1 },
+    { "approximate",    DistortionEngine::Shaping::approximate,    1 },
+    { "exact",          DistortionEngine::Shaping::exact,          1 },
+    { "antiderivative", DistortionEngine::Shaping::antiderivative, 1 },
+    { "exact",          DistortionEngine::Shaping::exact,          2 },
+    { "antiderivative", DistortionEngine::Shaping::antiderivative, 2 },
+    { "polynomial",     DistortionEngine::Shaping::polynomial,     2 },
+    { "exact",          DistortionEngine::Shaping::exact,          4 },
+    { "polynomial",     DistortionEngine::Shaping::polynomial,     4 },
+    { "exact",          DistortionEngine::Shaping::exact,          8 },
+    { "polynomial",     DistortionEngine::Shaping::polynomial,     8 },
+};
+
+//=============// TEST SIGNALS //=============//
+struct TestSignal {
+    juce::String name;
+    std::vector<int> toneBins;
+    std::vector<float> samples; // warmupLength + fftSize, periodic over fftSize
+};
+
+int toGridBin(double frequency) {
+    return juce::jmax(1, juce::roundToInt(frequency * fftSize / sampleRate / gridSpacing)) * gridSpacing;
+}
+
+TestSignal createTones(const juce::String& name, std::initializer_list<double> frequencies, double totalAmplitude) {
+    TestSignal signal { name, {}, std::vector<float>((size_t) (warmupLength + fftSize), 0.0f) };
+    const double amplitude = totalAmplitude / (double) frequencies.size();
+
+    for (double frequency : frequencies) {
+        const int bin = toGridBin(frequency);
+        signal.toneBins.push_back(bin);
+
+        // Phases spread out, so the tones don't all peak together
+        const double offset = juce::MathConstants<double>::halfPi * (double) signal.toneBins.size() * 0.37;
+
+        for (int i = 0; i < warmupLength + fftSize; ++i)
+            signal.samples[(size_t) i] += (float) (amplitude * std::sin(juce::MathConstants<double>::twoPi * bin * (i % fftSize) / fftSize + offset));
+    }
+
+    return signal;
+}
+
+std::vector<TestSignal> createTestSignals() {
+    std::vector<TestSignal> signals;
+
+    // A stepped sine sweep, stepped rather than gliding so every tone sits on a bin
+    for (double frequency : { 100.0, 300.0, 1000.0, 3000.0, 6000.0, 10000.0, 15000.0 })
+        signals.push_back(createTones("sine " + juce::String(juce::roundToInt(toGridBin(frequency) * sampleRate / fftSize)) + " Hz",
+                                      { frequency }, 0.5));
+
+    // High tones close together, like the CCIF test, then a spread for something music-like
+    signals.push_back(createTones("two-tone 19k/20k", { 19000.0, 20000.0 }, 0.5));
+    signals.push_back(createTones("multi-tone", { 110.0, 440.0, 1700.0, 5100.0, 12300.0 }, 0.5));
+
+    return signals;
+}
+
+//=============// RENDERING //================//
+// The same chain the processor builds around the curves, on one channel
+double render(const DSPKernels::KernelTable& kernels, int algorithm, const Mode& mode, float drive,
+              const std::vector<float>& input, std::vector<float>& output) {
+    DistortionEngine engine;
+    engine.prepare(1);
+    engine.setKernels(kernels);
+    engine.setDistortionAlgorithm(algorithm);
+    engine.setDrive(drive);
+    engine.setModulation(0.0f);
+    engine.setDownsampleFactor(4.0f * (float) mode.oversamplingFactor);
+    engine.setDownsampleBandLimited(true);
+    engine.setShaping(mode.shaping);
+    engine.setPolynomialDegree(DistortionEngine::getAliasFreeDegree(mode.oversamplingFactor));
+    engine.setSampleRate(sampleRate * mode.oversamplingFactor);
+
+    Oversampler oversampler;
+    oversampler.prepare(1);
+    oversampler.setFactor(mode.oversamplingFactor);
+
+    const int factor = mode.oversamplingFactor;
+    std::vector<float> upsampled((size_t) (blockSize * factor));
+    const std::vector<float> upsampledDrive((size_t) (blockSize * factor), drive);
+
+    output = input;
+
+    const auto start = juce::Time::getHighResolutionTicks();
+
+    for (int position = 0; position < (int) output.size(); position += blockSize) {
+        const int numSamples = juce::jmin(blockSize, (int) output.size() - position);
+        float* data = output.data() + position;
+
+        if (factor > 1) {
+            oversampler.upsample(0, data, 1, upsampled.data(), numSamples);
+            engine.processBlock(0, upsampled.data(), upsampledDrive.data(), numSamples * factor);
+            oversampler.downsample(0, upsampled.data(), data, 1, numSamples);
+        }
+        else {
+            engine.processBlock(0, data, upsampledDrive.data(), numSamples);
+        }
+    }
+
+    // CPU seconds per second of audio
+    return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) / (output.size() / sampleRate);
+}
+
+//=============// MEASUREMENT //==============//
+// In dB. Distortion is against the tones, aliasing against everything that
+// came out, DC included, since Rectify leaves next to nothing at the tones.
+struct Measurement {
+    double distortion;     // harmonics and intermodulation, THD for a single tone
+    double aliasing;       // everything off the grid
+    double aliasingBelow;  // off the grid under the lowest tone, where nothing masks it
+};
+
+double toDecibels(double power, double reference) {
+    return juce::jlimit(-300.0, 300.0, 10.0 * std::log10((power + 1.0e-30) / (reference + 1.0e-30)));
+}
+
+Measurement measure(const juce::dsp::FFT& fft, const std::vector<float>& output, const std::vector<int>& toneBins) {
+    std::vector<float> spectrum((size_t) (2 * fftSize), 0.0f);
+    std::copy(output.end() - fftSize, output.end(), spectrum.begin());
+
+    fft.performFrequencyOnlyForwardTransform(spectrum.data(), true);
+
+    const int lowestTone = *std::min_element(toneBins.begin(), toneBins.end());
+    double tonePower = 0.0, distortionPower = 0.0, aliasingPower = 0.0, aliasingBelowPower = 0.0;
+
+    // DC only counts towards the total, Rectify puts plenty there on purpose
+    const double dcPower = (double) spectrum[0] * spectrum[0];
+
+    for (int bin = 1; bin < fftSize / 2; ++bin) {
+        const double power = (double) spectrum[(size_t) bin] * spectrum[(size_t) bin];
+
+        if (std::find(toneBins.begin(), toneBins.end(), bin) != toneBins.end())
+            tonePower += power;
+        else if (bin % gridSpacing == 0)
+            distortionPower += power;
+        else {
+            aliasingPower += power;
+
+            if (bin < lowestTone)
+                aliasingBelowPower += power;
+        }
+    }
+
+    const double totalPower = dcPower + tonePower + distortionPower + aliasingPower;
+
+    return { toDecibels(distortionPower, tonePower), toDecibels(aliasingPower, totalPower), toDecibels(aliasingBelowPower, totalPower) };
+}
+
+} // namespace
+
+juce::String Diagnostics::runAliasingSuite(const juce::File& csvFile) {
+    // The oversamplers need the real filters, and the table mode the real tables
+    juce::SharedResourcePointer<DSPTables> tables;
+
+    while (!tables->isReady())
+        juce::Thread::sleep(1);
+
+    const auto& kernels = DSPKernels::getKernels(DSPKernels::selectInstructionSet());
+    const auto signals = createTestSignals();
+    const float drives[] = { 1.0f, 2.0f, 5.0f, 10.0f, 20.0f };
+
+    juce::dsp::FFT fft(fftOrder);
+    std::vector<float> output;
+
+    juce::String csv = "algorithm,mode,oversampling,drive,signal,distortion_db,aliasing_db,aliasing_below_db,cpu_per_second\n";
+    juce::String report = juce::String("Ignition aliasing suite (") + kernels.name + "), worst aliasing and mean CPU over "
+                        + juce::String((int) std::size(drives)) + " drives and " + juce::String((int) signals.size()) + " signals:\n";
+
+    for (int algorithm = 0; algorithm < (int) std::size(algorithmNames); ++algorithm) {
+        report += "  " + juce::String(algorithmNames[algorithm]) + "\n";
+
+        for (const auto& mode : modes) {
+            const juce::String modeName = juce::String(mode.name) + " " + juce::String(mode.oversamplingFactor) + "x";
+            double worstAliasing = -300.0, totalCpu = 0.0;
+            int numRuns = 0;
+
+            for (float drive : drives) {
+                for (const auto& signal : signals) {
+                    const double cpu = render(kernels, algorithm, mode, drive, signal.samples, output);
+                    const auto measurement = measure(fft, output, signal.toneBins);
+
+                    csv << algorithmNames[algorithm] << "," << mode.name << "," << mode.oversamplingFactor << ","
+                        << juce::String(drive, 2) << "," << signal.name << "," << juce::String(measurement.distortion, 2) << ","
+                        << juce::String(measurement.aliasing, 2) << "," << juce::String(measurement.aliasingBelow, 2) << ","
+                        << juce::String(cpu, 6) << "\n";
+
+                    worstAliasing = juce::jmax(worstAliasing, measurement.aliasing);
+                    totalCpu += cpu;
+                    ++numRuns;
+                }
+            }
+
+            report += "    " + modeName.paddedRight(' ', 20) + "aliasing " + juce::String(worstAliasing, 1) + " dB, CPU "
+                    + juce::String(totalCpu / numRuns * 100.0, 3) + "% of a core\n";
+        }
+    }
+
+    if (csvFile.replaceWithText(csv))
+        report += "  every measurement written to " + csvFile.getFullPathName() + "\n";
+    else
+        report += "  couldn't write " + csvFile.getFullPathName() + "\n";
+
+    return report;
+}
+
+#endif
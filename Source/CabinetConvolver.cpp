@@ -0,0 +1,618 @@
+/*
+  ==============================================================================
+
+    CabinetConvolver.cpp
+    Created: 19 Oct 2026 1:18:52pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#include "CabinetConvolver.h"
+#include "TraceRecorder.h"
+
+namespace
+{
+    constexpr int tailRingSize = 4;
+
+    int orderFor(int fftSize) {
+        int order = 0;
+
+        while ((1 << order) < fftSize)
+            ++order;
+
+        return order;
+    }
+
+    // Number of floats in a non-negative frequency spectrum from performRealOnlyForwardTransform
+    int spectrumSize(int fftSize) {
+        return (fftSize / 2 + 1) * 2;
+    }
+
+    void multiplyAccumulate(float* acc, const float* a, const float* b, int numFloats) {
+        for (int i = 0; i < numFloats; i += 2)
+        {
+            acc[i]     += a[i] * b[i]     - a[i + 1] * b[i + 1];
+            acc[i + 1] += a[i] * b[i + 1] + a[i + 1] * b[i];
+        }
+    }
+
+    void partitionSpectra(const juce::dsp::FFT& fft, const float* impulse, int length,
+                          int offset, int partitionSize, int numPartitions, std::vector<float>& spectra) {
+        const int fftSize = 2 * partitionSize;
+        const int specSize = spectrumSize(fftSize);
+
+        std::vector<float> buffer((size_t) (2 * fftSize));
+        spectra.assign((size_t) (numPartitions * specSize), 0.0f);
+
+        for (int p = 0; p < numPartitions; ++p)
+        {
+            std::fill(buffer.begin(), buffer.end(), 0.0f);
+
+            const int start = offset + p * partitionSize;
+            const int count = juce::jmin(partitionSize, length - start);
+            std::copy(impulse + start, impulse + start + count, buffer.begin());
+
+            fft.performRealOnlyForwardTransform(buffer.data(), true);
+            std::copy(buffer.begin(), buffer.begin() + specSize, spectra.begin() + p * specSize);
+        }
+    }
+}
+
+//==============================================================================
+struct CabinetConvolver::State {
+    State(int numChannelsIn, int numImpulseChannelsIn, int numMidIn, int numTailIn, int generationIn)
+        : generation(generationIn), numChannels(numChannelsIn), numImpulseChannels(numImpulseChannelsIn),
+          numMid(numMidIn), numTail(numTailIn)
+    {
+        const auto channels = (size_t) numChannels;
+        const auto impulseChannels = (size_t) numImpulseChannels;
+
+        headTaps.assign(impulseChannels, std::vector<float>(headSize, 0.0f));
+        midSpectra.resize(impulseChannels);
+        tailSpectra.resize(impulseChannels);
+
+        const int midSpecSize = spectrumSize(2 * headSize);
+        line.assign(channels, std::vector<float>(2 * headSize, 0.0f));
+        midFdl.assign(channels, std::vector<float>((size_t) (juce::jmax(1, numMid) * midSpecSize), 0.0f));
+        midOut.assign(channels, std::vector<float>(headSize, 0.0f));
+        midBuffer.assign(4 * headSize, 0.0f); // two FFT sizes, as the real-only transforms want
+        headScratch.assign(headSize, 0.0f);
+
+        const int tailSpecSize = spectrumSize(2 * tailPartitionSize);
+        const int tailChannels = numTail > 0 ? numChannels : 0;
+        tailIn.assign((size_t) tailChannels, std::vector<float>(tailRingSize * tailPartitionSize, 0.0f));
+        tailOut.assign((size_t) tailChannels, std::vector<float>(tailRingSize * tailPartitionSize, 0.0f));
+        tailFdl.assign((size_t) tailChannels, std::vector<float>((size_t) (numTail * tailSpecSize), 0.0f));
+        tailBuffer.assign(numTail > 0 ? 4 * tailPartitionSize : 0, 0.0f);
+
+        for (auto& stamp : inStamp)
+            stamp.store(-1);
+    }
+
+    int getImpulseChannel(int channel) const noexcept {
+        return juce::jmin(channel, numImpulseChannels - 1);
+    }
+
+    const int generation;
+    const int numChannels, numImpulseChannels;
+    const int numMid, numTail;
+
+    // The impulse response, per impulse channel
+    std::vector<std::vector<float>> headTaps, midSpectra, tailSpectra;
+
+    // Head and mid partitions, audio thread only
+    juce::dsp::FFT midFFT{ orderFor(2 * headSize) };
+    std::vector<std::vector<float>> line; // previous and current head block of input
+    std::vector<std::vector<float>> midFdl, midOut;
+    std::vector<float> midBuffer, headScratch;
+    int midPos = 0, midFdlPos = 0;
+
+    // Tail partitions, shared with the worker through the ring buffers below
+    juce::dsp::FFT tailFFT{ orderFor(2 * tailPartitionSize) };
+    std::vector<std::vector<float>> tailIn, tailOut, tailFdl;
+    std::vector<float> tailBuffer;
+    int tailFdlPos = 0;
+
+    std::atomic<juce::int64> inStamp[tailRingSize]; // which tail block each input slot holds
+    std::atomic<juce::int64> submitted{ -1 }, processed{ -1 };
+
+    juce::int64 tailBlock = 0;
+    int tailPos = 0;
+    bool tailWritable = true, tailReadable = true;
+};
+
+//==============================================================================
+class CabinetConvolver::TailWorker : public juce::Thread {
+public:
+    TailWorker(CabinetConvolver& ownerIn) : juce::Thread("Ignition cabinet tail"), owner(ownerIn) {}
+
+    void run() override {
+        // Only ever woken by a block that submitted tail work, or by stopThread()
+        while (! threadShouldExit())
+        {
+            wait(-1);
+
+            if (threadShouldExit())
+                break;
+
+            IGNITION_TRACE_ZONE("cabinet tail");
+            const juce::SpinLock::ScopedLockType lock(owner.tailLock);
+
+            if (owner.current != nullptr)
+                owner.processPendingTailJobs(*owner.current);
+        }
+    }
+
+private:
+    CabinetConvolver& owner;
+};
+
+//==============================================================================
+// The loader thread is shared, so each job remembers which instance queued it
+class CabinetConvolver::LoadJob : public juce::ThreadPoolJob {
+public:
+    LoadJob(CabinetConvolver& ownerIn, std::function<void()> workIn)
+        : juce::ThreadPoolJob("Ignition impulse response"), owner(ownerIn), work(std::move(workIn)) {}
+
+    JobStatus runJob() override {
+        work();
+        return jobHasFinished;
+    }
+
+    CabinetConvolver& owner;
+
+private:
+    std::function<void()> work;
+};
+
+//==============================================================================
+CabinetConvolver::CabinetConvolver() {
+
+}
+
+CabinetConvolver::~CabinetConvolver() {
+    // Only our own jobs, other instances may be loading on the same thread
+    struct OwnedBy : public juce::ThreadPool::JobSelector {
+        explicit OwnedBy(const CabinetConvolver& ownerIn) : owner(ownerIn) {}
+
+        bool isJobSuitable(juce::ThreadPoolJob* job) override {
+            auto* load = dynamic_cast<LoadJob*>(job);
+            return load != nullptr && &load->owner == &owner;
+        }
+
+        const CabinetConvolver& owner;
+    } ownJobs(*this);
+
+    loader->pool.removeAllJobs(true, 5000, &ownJobs);
+
+    if (worker != nullptr)
+        worker->stopThread(1000);
+
+    delete current;
+    delete pending.exchange(nullptr);
+    delete retired.exchange(nullptr);
+}
+
+void CabinetConvolver::prepare(const juce::dsp::ProcessSpec& newSpec) {
+    {
+        const juce::ScopedLock sl(impulseLock);
+        spec = newSpec;
+        ++generation;
+    }
+
+    {
+        const juce::SpinLock::ScopedLockType lock(tailLock);
+        delete current;
+        current = nullptr;
+    }
+
+    delete pending.exchange(nullptr);
+    delete retired.exchange(nullptr);
+
+    // The IR has to be resampled for the new rate
+    rebuildFromLoadedImpulse();
+}
+
+void CabinetConvolver::loadImpulseResponse(const juce::File& file) {
+    addLoaderJob([this, file]
+    {
+        IGNITION_TRACE_ZONE("load impulse response");
+
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+
+        if (reader == nullptr)
+        {
+            DBG("Couldn't read impulse response " << file.getFullPathName());
+            return;
+        }
+
+        const auto maxLength = (juce::int64) (maxImpulseSeconds * reader->sampleRate);
+        const int length = (int) juce::jmin(reader->lengthInSamples, maxLength);
+
+        juce::AudioBuffer<float> impulse((int) juce::jmin(reader->numChannels, 2u), length);
+        reader->read(&impulse, 0, length, 0, true, true);
+
+        {
+            const juce::ScopedLock sl(impulseLock);
+            loadedImpulse = impulse;
+            loadedImpulseSampleRate = reader->sampleRate;
+            impulseFile = file;
+        }
+
+        rebuildFromLoadedImpulse();
+    });
+}
+
+void CabinetConvolver::addLoaderJob(std::function<void()> work) {
+    loader->pool.addJob(new LoadJob(*this, std::move(work)), true);
+}
+
+juce::File CabinetConvolver::getImpulseResponseFile() const {
+    const juce::ScopedLock sl(impulseLock);
+    return impulseFile;
+}
+
+void CabinetConvolver::copyImpulseResponseFrom(const CabinetConvolver& other) {
+    juce::AudioBuffer<float> impulse;
+    double impulseSampleRate;
+    juce::File file;
+
+    {
+        const juce::ScopedLock sl(other.impulseLock);
+        impulse = other.loadedImpulse;
+        impulseSampleRate = other.loadedImpulseSampleRate;
+        file = other.impulseFile;
+    }
+
+    const juce::ScopedLock sl(impulseLock);
+    loadedImpulse = impulse;
+    loadedImpulseSampleRate = impulseSampleRate;
+    impulseFile = file;
+    buildInline = true;
+}
+
+double CabinetConvolver::getImpulseResponseSeconds() const {
+    const juce::ScopedLock sl(impulseLock);
+
+    if (loadedImpulseSampleRate <= 0.0)
+        return 0.0;
+
+    return loadedImpulse.getNumSamples() / loadedImpulseSampleRate;
+}
+
+void CabinetConvolver::setNonRealtime(bool shouldBeNonRealtime) noexcept {
+    nonRealtime = shouldBeNonRealtime;
+}
+
+int CabinetConvolver::getNumOverruns() const noexcept {
+    return overruns.load();
+}
+
+void CabinetConvolver::rebuildFromLoadedImpulse() {
+    juce::AudioBuffer<float> impulse;
+    double impulseSampleRate, sampleRate;
+    int numChannels, stateGeneration;
+
+    {
+        const juce::ScopedLock sl(impulseLock);
+
+        if (loadedImpulse.getNumSamples() == 0)
+            return;
+
+        impulse = loadedImpulse;
+        impulseSampleRate = loadedImpulseSampleRate;
+        sampleRate = spec.sampleRate;
+        numChannels = (int) spec.numChannels;
+        stateGeneration = generation.load();
+    }
+
+    if (buildInline)
+    {
+        buildState(impulse, impulseSampleRate, sampleRate, numChannels, stateGeneration);
+        return;
+    }
+
+    addLoaderJob([this, impulse, impulseSampleRate, sampleRate, numChannels, stateGeneration]
+    {
+        IGNITION_TRACE_ZONE("prepare impulse response");
+        buildState(impulse, impulseSampleRate, sampleRate, numChannels, stateGeneration);
+    });
+}
+
+void CabinetConvolver::buildState(const juce::AudioBuffer<float>& impulse, double impulseSampleRate,
+                                  double sampleRate, int numChannels, int stateGeneration) {
+    delete retired.exchange(nullptr);
+
+    if (impulse.getNumSamples() == 0 || numChannels <= 0)
+        return;
+
+    //=============// RESAMPLE //=============//
+    const int numImpulseChannels = impulse.getNumChannels();
+    const double ratio = impulseSampleRate / sampleRate;
+    const int length = juce::jmin((int) std::ceil(impulse.getNumSamples() / ratio), (int) (maxImpulseSeconds * sampleRate));
+
+    if (length <= 0)
+        return;
+
+    juce::AudioBuffer<float> resampled(numImpulseChannels, length);
+
+    for (int channel = 0; channel < numImpulseChannels; ++channel)
+    {
+        // The interpolator reads a few samples past the end
+        std::vector<float> padded((size_t) impulse.getNumSamples() + 16, 0.0f);
+        std::copy(impulse.getReadPointer(channel), impulse.getReadPointer(channel) + impulse.getNumSamples(), padded.begin());
+
+        if (ratio == 1.0)
+        {
+            std::copy(padded.begin(), padded.begin() + length, resampled.getWritePointer(channel));
+        }
+        else
+        {
+            juce::LagrangeInterpolator interpolator;
+            interpolator.process(ratio, padded.data(), resampled.getWritePointer(channel), length);
+        }
+    }
+
+    // Normalise to unity energy so swapping cabinets doesn't jump in level
+    float energy = 0.0f;
+
+    for (int channel = 0; channel < numImpulseChannels; ++channel)
+    {
+        float channelEnergy = 0.0f;
+
+        for (int i = 0; i < length; ++i)
+            channelEnergy += resampled.getSample(channel, i) * resampled.getSample(channel, i);
+
+        energy = juce::jmax(energy, channelEnergy);
+    }
+
+    if (energy > 0.0f)
+        resampled.applyGain(1.0f / std::sqrt(energy));
+
+    //=============// PARTITION //=============//
+    const int tailStart = 2 * tailPartitionSize;
+    const int numMid = length > headSize ? (juce::jmin(length, tailStart) - headSize + headSize - 1) / headSize : 0;
+    const int numTail = length > tailStart ? (length - tailStart + tailPartitionSize - 1) / tailPartitionSize : 0;
+
+    auto state = std::make_unique<State>(numChannels, numImpulseChannels, numMid, numTail, stateGeneration);
+
+    for (int channel = 0; channel < numImpulseChannels; ++channel)
+    {
+        const float* ir = resampled.getReadPointer(channel);
+
+        std::copy(ir, ir + juce::jmin(length, (int) headSize), state->headTaps[(size_t) channel].begin());
+
+        partitionSpectra(state->midFFT, ir, length, headSize, headSize, numMid, state->midSpectra[(size_t) channel]);
+        partitionSpectra(state->tailFFT, ir, length, tailStart, tailPartitionSize, numTail, state->tailSpectra[(size_t) channel]);
+    }
+
+    if (stateGeneration != generation.load())
+        return; // prepare() was called while we were building
+
+    if (numTail > 0 && worker == nullptr)
+    {
+        worker = std::make_unique<TailWorker>(*this);
+        worker->startThread(juce::Thread::Priority::high);
+    }
+
+    delete pending.exchange(state.release());
+}
+
+void CabinetConvolver::installPendingState() {
+    if (pending.load() == nullptr || retired.load() != nullptr)
+        return;
+
+    // Only swap while the worker is idle, otherwise try again next block
+    if (! tailLock.tryEnter())
+        return;
+
+    if (auto* next = pending.exchange(nullptr))
+    {
+        if (next->generation == generation.load())
+        {
+            retired.store(current);
+            current = next;
+        }
+        else
+        {
+            retired.store(next);
+        }
+    }
+
+    tailLock.exit();
+}
+
+//==============================================================================
+void CabinetConvolver::process(float* const* channels, int numChannels, int numSamples) {
+    installPendingState();
+
+    if (current == nullptr)
+        return;
+
+    State& state = *current;
+    numChannels = juce::jmin(numChannels, state.numChannels);
+
+    int done = 0;
+
+    while (done < numSamples)
+    {
+        const int n = juce::jmin(numSamples - done, headSize - state.midPos, tailPartitionSize - state.tailPos);
+        const size_t tailOffset = (size_t) ((state.tailBlock % tailRingSize) * tailPartitionSize + state.tailPos);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            float* x = channels[channel] + done;
+            float* line = state.line[(size_t) channel].data();
+            float* y = state.headScratch.data();
+            const float* taps = state.headTaps[(size_t) state.getImpulseChannel(channel)].data();
+
+            juce::FloatVectorOperations::copy(line + headSize + state.midPos, x, n);
+
+            if (state.numTail > 0 && state.tailWritable)
+                juce::FloatVectorOperations::copy(state.tailIn[(size_t) channel].data() + tailOffset, x, n);
+
+            // Mid partitions were computed at the end of the last head block
+            juce::FloatVectorOperations::copy(y, state.midOut[(size_t) channel].data() + state.midPos, n);
+
+            // Direct form head
+            for (int i = 0; i < headSize; ++i)
+                juce::FloatVectorOperations::addWithMultiply(y, line + headSize + state.midPos - i, taps[i], n);
+
+            if (state.numTail > 0 && state.tailReadable)
+                juce::FloatVectorOperations::add(y, state.tailOut[(size_t) channel].data() + tailOffset, n);
+
+            juce::FloatVectorOperations::copy(x, y, n);
+        }
+
+        state.midPos += n;
+        state.tailPos += n;
+        done += n;
+
+        if (state.midPos == headSize)
+            processMidBlock(state);
+
+        if (state.tailPos == tailPartitionSize)
+            finishTailBlock(state);
+    }
+}
+
+void CabinetConvolver::processMidBlock(State& state) {
+    const int fftSize = 2 * headSize;
+    const int specSize = spectrumSize(fftSize);
+
+    for (int channel = 0; channel < state.numChannels; ++channel)
+    {
+        float* line = state.line[(size_t) channel].data();
+
+        if (state.numMid > 0)
+        {
+            float* buffer = state.midBuffer.data();
+            float* fdl = state.midFdl[(size_t) channel].data();
+            const float* spectra = state.midSpectra[(size_t) state.getImpulseChannel(channel)].data();
+
+            juce::FloatVectorOperations::copy(buffer, line, fftSize);
+            juce::FloatVectorOperations::clear(buffer + fftSize, fftSize);
+            state.midFFT.performRealOnlyForwardTransform(buffer, true);
+            juce::FloatVectorOperations::copy(fdl + state.midFdlPos * specSize, buffer, specSize);
+
+            juce::FloatVectorOperations::clear(buffer, 2 * fftSize);
+
+            for (int j = 0; j < state.numMid; ++j)
+            {
+                const int slot = (state.midFdlPos - j + state.numMid) % state.numMid;
+                multiplyAccumulate(buffer, fdl + slot * specSize, spectra + j * specSize, specSize);
+            }
+
+            state.midFFT.performRealOnlyInverseTransform(buffer);
+            juce::FloatVectorOperations::copy(state.midOut[(size_t) channel].data(), buffer + headSize, headSize);
+        }
+
+        juce::FloatVectorOperations::copy(line, line + headSize, headSize);
+    }
+
+    if (state.numMid > 0)
+        state.midFdlPos = (state.midFdlPos + 1) % state.numMid;
+
+    state.midPos = 0;
+}
+
+void CabinetConvolver::finishTailBlock(State& state) {
+    if (state.numTail > 0)
+    {
+        if (state.tailWritable)
+        {
+            state.inStamp[state.tailBlock % tailRingSize].store(state.tailBlock);
+            state.submitted.store(state.tailBlock);
+
+            if (nonRealtime.load())
+            {
+                const juce::SpinLock::ScopedLockType lock(tailLock);
+                processPendingTailJobs(state);
+            }
+            else if (worker != nullptr)
+            {
+                worker->notify();
+            }
+        }
+
+        ++state.tailBlock;
+
+        // Block n's tail was submitted at the end of block n - 2
+        const auto processed = state.processed.load();
+        state.tailWritable = processed >= state.tailBlock + 2 - tailRingSize;
+        state.tailReadable = processed >= state.tailBlock - 2;
+
+        if (! state.tailReadable)
+            ++overruns;
+    }
+
+    state.tailPos = 0;
+}
+
+void CabinetConvolver::processPendingTailJobs(State& state) {
+    if (state.numTail == 0)
+        return;
+
+    const int fftSize = 2 * tailPartitionSize;
+    const int specSize = spectrumSize(fftSize);
+    const auto last = state.submitted.load();
+
+    for (auto job = state.processed.load() + 1; job <= last; ++job)
+    {
+        const int slot = (int) (job % tailRingSize);
+        const int previousSlot = (slot + tailRingSize - 1) % tailRingSize;
+        const int outputSlot = (int) ((job + 2) % tailRingSize);
+
+        // The audio thread skips blocks when we fall too far behind
+        const bool valid = state.inStamp[slot].load() == job;
+        const bool previousValid = state.inStamp[previousSlot].load() == job - 1;
+
+        for (int channel = 0; channel < state.numChannels; ++channel)
+        {
+            float* output = state.tailOut[(size_t) channel].data() + outputSlot * tailPartitionSize;
+            float* fdl = state.tailFdl[(size_t) channel].data();
+
+            if (! valid)
+            {
+                juce::FloatVectorOperations::clear(output, tailPartitionSize);
+                juce::FloatVectorOperations::clear(fdl, state.numTail * specSize);
+                continue;
+            }
+
+            const float* input = state.tailIn[(size_t) channel].data();
+            const float* spectra = state.tailSpectra[(size_t) state.getImpulseChannel(channel)].data();
+            float* buffer = state.tailBuffer.data();
+
+            if (previousValid)
+                juce::FloatVectorOperations::copy(buffer, input + previousSlot * tailPartitionSize, tailPartitionSize);
+            else
+                juce::FloatVectorOperations::clear(buffer, tailPartitionSize);
+
+            juce::FloatVectorOperations::copy(buffer + tailPartitionSize, input + slot * tailPartitionSize, tailPartitionSize);
+            juce::FloatVectorOperations::clear(buffer + fftSize, fftSize);
+
+            state.tailFFT.performRealOnlyForwardTransform(buffer, true);
+            juce::FloatVectorOperations::copy(fdl + state.tailFdlPos * specSize, buffer, specSize);
+
+            juce::FloatVectorOperations::clear(buffer, 2 * fftSize);
+
+            for (int j = 0; j < state.numTail; ++j)
+            {
+                const int fdlSlot = (state.tailFdlPos - j + state.numTail) % state.numTail;
+                multiplyAccumulate(buffer, fdl + fdlSlot * specSize, spectra + j * specSize, specSize);
+            }
+
+            state.tailFFT.performRealOnlyInverseTransform(buffer);
+            juce::FloatVectorOperations::copy(output, buffer + tailPartitionSize, tailPartitionSize);
+        }
+
+        if (valid)
+            state.tailFdlPos = (state.tailFdlPos + 1) % state.numTail;
+
+        state.processed.store(job);
+    }
+}
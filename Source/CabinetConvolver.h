@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    CabinetConvolver.h
+    Created: 19 Oct 2026 1:18:52pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <JuceHeader.h>
+
+// Zero latency cabinet impulse response convolution.
+//
+// The IR is split non-uniformly:
+//   - taps [0, headSize) run as a direct form FIR on the audio thread
+//   - taps [headSize, 2 * tailPartitionSize) run as uniformly partitioned FFT
+//     convolution with headSize blocks, also on the audio thread
+//   - everything after that runs with tailPartitionSize blocks on a
+//     background thread, which gets one whole tail block of slack
+//
+// Loading, resampling and partitioning happen on a loader thread shared by
+// every instance and the finished IR is swapped in atomically at the start
+// of a block.
+class CabinetConvolver {
+public:
+	static constexpr int headSize = 64;
+	static constexpr int tailPartitionSize = 1024;
+	static constexpr double maxImpulseSeconds = 2.0;
+
+	CabinetConvolver();
+	~CabinetConvolver();
+
+	void prepare(const juce::dsp::ProcessSpec& spec);
+
+	// Safe to call from any thread, the work happens on the loader thread
+	void loadImpulseResponse(const juce::File& file);
+	juce::File getImpulseResponseFile() const;
+
+	// How long the loaded IR rings on for, 0 without one
+	double getImpulseResponseSeconds() const;
+
+	// For a copy that has to sound the same from its first block: takes the
+	// other's IR as loaded, and from then on builds it in prepare() instead of
+	// on the loader thread
+	void copyImpulseResponseFrom(const CabinetConvolver& other);
+
+	// When rendering offline the tail is computed in line instead of on the
+	// background thread, so it can never miss its deadline
+	void setNonRealtime(bool shouldBeNonRealtime) noexcept;
+
+	int getNumOverruns() const noexcept;
+
+	void process(float* const* channels, int numChannels, int numSamples);
+
+private:
+	struct State;
+	class TailWorker;
+	class LoadJob;
+
+	// One loader thread for the whole process rather than one per instance
+	struct SharedLoader {
+		juce::ThreadPool pool{ 1 };
+	};
+
+	void buildState(const juce::AudioBuffer<float>& impulse, double impulseSampleRate,
+	                double sampleRate, int numChannels, int stateGeneration);
+	void addLoaderJob(std::function<void()> work);
+	void rebuildFromLoadedImpulse();
+	void processMidBlock(State& state);
+	void finishTailBlock(State& state);
+	void processPendingTailJobs(State& state);
+	void installPendingState();
+
+	juce::dsp::ProcessSpec spec{ 44100.0, 512, 2 };
+	std::atomic<int> generation{ 0 };
+
+	State* current = nullptr;               // owned by the audio thread
+	std::atomic<State*> pending{ nullptr }; // built by the loader, waiting to be swapped in
+	std::atomic<State*> retired{ nullptr }; // swapped out, waiting to be deleted off the audio thread
+
+	juce::SpinLock tailLock; // held while anyone touches the tail of the current state
+
+	std::unique_ptr<TailWorker> worker;
+	juce::SharedResourcePointer<SharedLoader> loader;
+
+	juce::CriticalSection impulseLock;
+	juce::AudioBuffer<float> loadedImpulse; // as read from disk, before resampling
+	double loadedImpulseSampleRate = 0.0;
+	juce::File impulseFile;
+
+	std::atomic<bool> nonRealtime{ false };
+	std::atomic<bool> buildInline{ false };
+	std::atomic<int> overruns{ 0 };
+
+	JUCE_DECLARE_NON_COPYABLE(CabinetConvolver)
+};
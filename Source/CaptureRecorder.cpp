@@ -0,0 +1,221 @@
+/*
+  ==============================================================================
+
+    CaptureRecorder.cpp
+    Created: 19 Oct 2026 8:14:37pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#include "CaptureRecorder.h"
+#include "TraceRecorder.h"
+
+CaptureRecorder::CaptureRecorder()
+    : juce::Thread("Ignition capture writer") {
+}
+
+CaptureRecorder::~CaptureRecorder() {
+    stop();
+}
+
+juce::File CaptureRecorder::getCaptureDirectory() {
+    const auto path = juce::SystemStats::getEnvironmentVariable("IGNITION_CAPTURE", {});
+
+    if (path.isEmpty())
+        return {};
+
+    // Relative paths are taken from wherever the host was started
+    const auto directory = juce::File::getCurrentWorkingDirectory().getChildFile(path);
+    directory.createDirectory();
+
+    return directory;
+}
+
+void CaptureRecorder::start(const juce::File& file, double sampleRate, int maxBlockSize, int numChannels, int numParameters) {
+    stop();
+
+    stream = std::make_unique<juce::FileOutputStream>(file);
+
+    if (stream->failedToOpen()) {
+        stream.reset();
+        return;
+    }
+
+    if (ring == nullptr)
+        ring.allocate((size_t) ringSizeInBytes, false);
+
+    fifo.reset();
+
+    fileHeader = FileHeader();
+    fileHeader.sampleRate = sampleRate;
+    fileHeader.maxBlockSize = maxBlockSize;
+    fileHeader.numChannels = numChannels;
+    fileHeader.numParameters = numParameters;
+
+    stream->write(&fileHeader, sizeof(fileHeader));
+
+    blockSize = 0;
+    numDroppedSinceLast = 0;
+    numDroppedTotal = 0;
+
+    recording = true;
+    startThread(juce::Thread::Priority::low);
+}
+
+void CaptureRecorder::stop() {
+    if (stream == nullptr)
+        return;
+
+    recording = false;
+    stopThread(2000);
+
+    // Whatever the writer hadn't got to yet
+    writePendingBlocks();
+    stream->flush();
+    stream.reset();
+}
+
+bool CaptureRecorder::isRecording() const noexcept {
+    return recording.load(std::memory_order_relaxed);
+}
+
+juce::int64 CaptureRecorder::getNumDroppedBlocks() const noexcept {
+    return numDroppedTotal.load(std::memory_order_relaxed);
+}
+
+void CaptureRecorder::beginBlock(BlockHeader header, const float* parameters, const juce::AudioBuffer<float>& buffer) {
+    if (!isRecording())
+        return;
+
+    blockChannels = juce::jmin(buffer.getNumChannels(), (int) fileHeader.numChannels);
+    blockSamples = buffer.getNumSamples();
+    blockSize = (int) sizeof(BlockHeader) + (int) fileHeader.numParameters * (int) sizeof(float)
+              + blockChannels * blockSamples * (int) sizeof(float) + (int) sizeof(juce::uint64);
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(blockSize, start1, size1, start2, size2);
+
+    // Half a block would be no use to the replay, so it goes whole or not at all
+    if (size1 + size2 < blockSize) {
+        ++numDroppedSinceLast;
+        numDroppedTotal.fetch_add(1, std::memory_order_relaxed);
+        blockSize = 0;
+        return;
+    }
+
+    header.numChannels = blockChannels;
+    header.numSamples = blockSamples;
+    header.numDropped = numDroppedSinceLast;
+    numDroppedSinceLast = 0;
+
+    blockStart = start1;
+
+    int position = start1;
+    writeToRing(position, &header, (int) sizeof(header));
+    writeToRing(position, parameters, (int) fileHeader.numParameters * (int) sizeof(float));
+
+    for (int channel = 0; channel < blockChannels; ++channel)
+        writeToRing(position, buffer.getReadPointer(channel), blockSamples * (int) sizeof(float));
+}
+
+void CaptureRecorder::endBlock(const juce::AudioBuffer<float>& buffer) {
+    if (blockSize == 0)
+        return;
+
+    const juce::uint64 hash = hashChannels(buffer, blockChannels, blockSamples);
+
+    int position = (blockStart + blockSize - (int) sizeof(hash)) % ringSizeInBytes;
+    writeToRing(position, &hash, (int) sizeof(hash));
+
+    // Only now can the writer see the block. It polls, so there's nothing to signal.
+    fifo.finishedWrite(blockSize);
+    blockSize = 0;
+}
+
+void CaptureRecorder::writeToRing(int& position, const void* data, int numBytes) noexcept {
+    const auto* bytes = static_cast<const char*>(data);
+    const int first = juce::jmin(numBytes, ringSizeInBytes - position);
+
+    std::memcpy(ring + position, bytes, (size_t) first);
+    std::memcpy(ring.get(), bytes + first, (size_t) (numBytes - first));
+
+    position = (position + numBytes) % ringSizeInBytes;
+}
+
+void CaptureRecorder::run() {
+    while (!threadShouldExit()) {
+        wait(20);
+        writePendingBlocks();
+    }
+}
+
+void CaptureRecorder::writePendingBlocks() {
+    const int numReady = fifo.getNumReady();
+
+    if (numReady == 0)
+        return;
+
+    IGNITION_TRACE_ZONE("capture write");
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numReady, start1, size1, start2, size2);
+
+    stream->write(ring + start1, (size_t) size1);
+
+    if (size2 > 0)
+        stream->write(ring + start2, (size_t) size2);
+
+    fifo.finishedRead(size1 + size2);
+}
+
+bool CaptureRecorder::readFileHeader(juce::InputStream& input, FileHeader& header) {
+    return input.read(&header, (int) sizeof(header)) == (int) sizeof(header)
+        && header.magic == fileMagic
+        && header.version == fileVersion
+        && header.numChannels > 0
+        && header.numParameters >= 0;
+}
+
+bool CaptureRecorder::readBlock(juce::InputStream& input, const FileHeader& fileHeader, BlockHeader& header,
+                                float* parameters, juce::AudioBuffer<float>& buffer, juce::uint64& outputHash) {
+    if (input.read(&header, (int) sizeof(header)) != (int) sizeof(header))
+        return false;
+
+    // Anything else means the file is cut short or isn't a capture
+    if (header.numChannels < 0 || header.numChannels > fileHeader.numChannels
+        || header.numSamples < 0 || header.numSamples > (1 << 20))
+        return false;
+
+    const int parameterBytes = (int) fileHeader.numParameters * (int) sizeof(float);
+
+    if (input.read(parameters, parameterBytes) != parameterBytes)
+        return false;
+
+    buffer.setSize(header.numChannels, header.numSamples, false, false, true);
+
+    const int channelBytes = header.numSamples * (int) sizeof(float);
+
+    for (int channel = 0; channel < header.numChannels; ++channel)
+        if (input.read(buffer.getWritePointer(channel), channelBytes) != channelBytes)
+            return false;
+
+    return input.read(&outputHash, (int) sizeof(outputHash)) == (int) sizeof(outputHash);
+}
+
+juce::uint64 CaptureRecorder::hashChannels(const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept {
+    juce::uint64 hash = 14695981039346656037ull;
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        const float* samples = buffer.getReadPointer(channel);
+
+        for (int i = 0; i < numSamples; ++i) {
+            juce::uint32 bits;
+            std::memcpy(&bits, samples + i, sizeof(bits));
+
+            hash = (hash ^ bits) * 1099511628211ull;
+        }
+    }
+
+    return hash;
+}
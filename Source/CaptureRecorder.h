@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    CaptureRecorder.h
+    Created: 19 Oct 2026 8:14:37pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <JuceHeader.h>
+
+// Opt-in recorder for reproducing CPU spikes and glitches from the field.
+//
+// With IGNITION_CAPTURE set to a directory, every prepareToPlay starts a new
+// capture file in it. For each host block the audio thread copies the input,
+// the parameter snapshot, the playhead and a timestamp into a ring that was
+// allocated up front, and a background thread streams the ring to disk.
+// Nothing on the audio thread allocates, locks or touches the file. If the
+// writer falls behind, whole blocks are dropped and the next one says how many.
+//
+// A capture replays bit-exactly from the prepareToPlay that started it (see
+// the "replay" diagnostic), as long as the cabinet IR isn't in use and the
+// shared tables were ready throughout. The IR loads asynchronously and isn't
+// captured. Blocks processed while the tables were still building ran the
+// stand ins, and are flagged so the replay can tell them apart.
+class CaptureRecorder : private juce::Thread {
+public:
+	static constexpr juce::uint32 fileMagic = 0x49474e43; // "IGNC"
+	static constexpr int fileVersion = 2;
+
+	// About 20 seconds of stereo 48 kHz, plenty for the writer to keep up
+	static constexpr int ringSizeInBytes = 8 << 20;
+
+	// Written in native byte order, captures replay on the same kind of machine
+	struct FileHeader {
+		juce::uint32 magic = fileMagic;
+		juce::int32 version = fileVersion;
+		double sampleRate = 0.0;
+		juce::int32 maxBlockSize = 0;
+		juce::int32 numChannels = 0;
+		juce::int32 numParameters = 0;
+		juce::int32 reserved = 0;
+	};
+
+	enum BlockFlags {
+		hasBpm      = 1 << 0,
+		hasPpq      = 1 << 1,
+		isPlaying   = 1 << 2,
+		nonRealtime = 1 << 3,
+		tablesReady = 1 << 4  // DSPTables::isReady() at the start of the block
+	};
+
+	// Each block in the file is one of these, numParameters floats, the input
+	// channel after channel, and then the output's hash as a uint64
+	struct BlockHeader {
+		juce::int64 ticks = 0; // juce::Time::getHighResolutionTicks() when the block arrived
+		double bpm = 0.0;
+		double ppq = 0.0;
+		juce::int32 numChannels = 0;
+		juce::int32 numSamples = 0;
+		juce::uint32 numDropped = 0; // blocks lost just before this one
+		juce::uint32 flags = 0;
+	};
+
+	CaptureRecorder();
+	~CaptureRecorder() override;
+
+	// Where captures go, or an empty File when IGNITION_CAPTURE isn't set
+	static juce::File getCaptureDirectory();
+
+	// Not on the audio thread. Finishes whatever was being captured and starts
+	// writing to file.
+	void start(const juce::File& file, double sampleRate, int maxBlockSize, int numChannels, int numParameters);
+	void stop();
+
+	bool isRecording() const noexcept;
+	juce::int64 getNumDroppedBlocks() const noexcept;
+
+	// Audio thread. beginBlock copies the input before processing, endBlock
+	// adds the hash of the output and hands the block over to the writer.
+	void beginBlock(BlockHeader header, const float* parameters, const juce::AudioBuffer<float>& buffer);
+	void endBlock(const juce::AudioBuffer<float>& buffer);
+
+	// Reading captures back, false once the stream runs out or doesn't match
+	static bool readFileHeader(juce::InputStream& stream, FileHeader& header);
+	static bool readBlock(juce::InputStream& stream, const FileHeader& fileHeader, BlockHeader& header,
+	                      float* parameters, juce::AudioBuffer<float>& buffer, juce::uint64& outputHash);
+
+	// 64 bit FNV-1a of the samples' bits, so any difference at all shows up
+	static juce::uint64 hashChannels(const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept;
+
+private:
+	void run() override;
+	void writePendingBlocks();
+	void writeToRing(int& position, const void* data, int numBytes) noexcept;
+
+	juce::HeapBlock<char> ring;
+	juce::AbstractFifo fifo{ ringSizeInBytes };
+
+	std::unique_ptr<juce::FileOutputStream> stream;
+	FileHeader fileHeader;
+
+	std::atomic<bool> recording{ false };
+	std::atomic<juce::int64> numDroppedTotal{ 0 };
+
+	// Owned by the audio thread
+	int blockStart = 0, blockSize = 0, blockChannels = 0, blockSamples = 0;
+	juce::uint32 numDroppedSinceLast = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(CaptureRecorder)
+};
@@ -0,0 +1,184 @@
+/*
+  ==============================================================================
+
+    DSPKernels.cpp
+    Created: 19 Oct 2026 11:02:47am
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#include "DSPKernels.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+// Each block below compiles DSPKernelsImpl.h for one instruction set. MSVC
+// accepts every intrinsic without extra flags, GCC and Clang need the target
+// switched on around the functions that use them.
+#if JUCE_CLANG
+ #define IGNITION_BEGIN_TARGET(target) _Pragma(target)
+ #define IGNITION_END_TARGET _Pragma("clang attribute pop")
+#elif JUCE_GCC
+ #define IGNITION_BEGIN_TARGET(target) _Pragma("GCC push_options") _Pragma(target)
+ #define IGNITION_END_TARGET _Pragma("GCC pop_options")
+#else
+ #define IGNITION_BEGIN_TARGET(target)
+ #define IGNITION_END_TARGET
+#endif
+
+#if JUCE_CLANG
+ #define IGNITION_TARGET_SSE41  "clang attribute push (__attribute__((target(\"sse4.1\"))), apply_to = function)"
+ #define IGNITION_TARGET_AVX2   "clang attribute push (__attribute__((target(\"avx2,fma\"))), apply_to = function)"
+ #define IGNITION_TARGET_AVX512 "clang attribute push (__attribute__((target(\"avx512f,avx2,fma\"))), apply_to = function)"
+#else
+ #define IGNITION_TARGET_SSE41  "GCC target(\"sse4.1\")"
+ #define IGNITION_TARGET_AVX2   "GCC target(\"avx2,fma\")"
+ #define IGNITION_TARGET_AVX512 "GCC target(\"avx512f,avx2,fma\")"
+#endif
+
+namespace DSPKernels
+{
+
+#define IGNITION_KERNEL_ISA 0
+namespace scalar
+{
+ #include "DSPKernelsImpl.h"
+}
+#undef IGNITION_KERNEL_ISA
+
+#if JUCE_INTEL
+
+IGNITION_BEGIN_TARGET(IGNITION_TARGET_SSE41)
+#define IGNITION_KERNEL_ISA 1
+namespace sse41
+{
+ #include "DSPKernelsImpl.h"
+}
+#undef IGNITION_KERNEL_ISA
+IGNITION_END_TARGET
+
+IGNITION_BEGIN_TARGET(IGNITION_TARGET_AVX2)
+#define IGNITION_KERNEL_ISA 2
+namespace avx2
+{
+ #include "DSPKernelsImpl.h"
+}
+#undef IGNITION_KERNEL_ISA
+IGNITION_END_TARGET
+
+IGNITION_BEGIN_TARGET(IGNITION_TARGET_AVX512)
+#define IGNITION_KERNEL_ISA 3
+namespace avx512
+{
+ #include "DSPKernelsImpl.h"
+}
+#undef IGNITION_KERNEL_ISA
+IGNITION_END_TARGET
+
+#endif
+
+#define IGNITION_KERNEL_TABLE(isa) \
+    { InstructionSet::isa, #isa, isa::laneGroupSize, \
+      isa::distortBlock, isa::distortTableBlock, isa::chebyshevBlock, isa::quantizeBlock, isa::diodeClipperBlock, isa::envelopeBlock, \
+      isa::filterCoefficientsBlock, isa::filterLowpassBlock, isa::filterLowpassStereoBlock, isa::filterLowpassLanesBlock, isa::chainLanesBlock, \
+      isa::interleaveBlock, isa::packLanesBlock, isa::unpackLanesBlock, isa::encodeMidSideBlock, isa::decodeMidSideBlock, isa::decodeMidSideMixBlock, \
+      isa::mixBlock, isa::mixModulatedBlock, isa::levelsBlock, isa::polyphasePeakBlock }
+
+static const KernelTable scalarKernels = IGNITION_KERNEL_TABLE(scalar);
+
+#if JUCE_INTEL
+static const KernelTable sse41Kernels  = IGNITION_KERNEL_TABLE(sse41);
+static const KernelTable avx2Kernels   = IGNITION_KERNEL_TABLE(avx2);
+static const KernelTable avx512Kernels = IGNITION_KERNEL_TABLE(avx512);
+#endif
+
+#undef IGNITION_KERNEL_TABLE
+
+const char* getName(InstructionSet instructionSet) {
+    switch (instructionSet)
+    {
+    case InstructionSet::sse41:
+        return "sse41";
+    case InstructionSet::avx2:
+        return "avx2";
+    case InstructionSet::avx512:
+        return "avx512";
+    default:
+        return "scalar";
+    }
+}
+
+bool isSupported(InstructionSet instructionSet) {
+    switch (instructionSet)
+    {
+    case InstructionSet::scalar:
+        return true;
+#if JUCE_INTEL
+    case InstructionSet::sse41:
+        return juce::SystemStats::hasSSE41();
+    case InstructionSet::avx2:
+        return juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3();
+    case InstructionSet::avx512:
+        return juce::SystemStats::hasAVX512F() && juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3();
+#endif
+    default:
+        return false;
+    }
+}
+
+InstructionSet selectInstructionSet() {
+    const auto forced = juce::SystemStats::getEnvironmentVariable("IGNITION_ISA", {}).trim().toLowerCase();
+
+    if (forced.isNotEmpty())
+    {
+        for (int i = 0; i < (int) InstructionSet::numInstructionSets; ++i)
+        {
+            const auto instructionSet = static_cast<InstructionSet>(i);
+
+            if (forced == getName(instructionSet))
+            {
+                if (isSupported(instructionSet))
+                    return instructionSet;
+
+                juce::Logger::writeToLog("Ignition: IGNITION_ISA=" + forced + " is not supported on this CPU, picking automatically");
+                break;
+            }
+        }
+    }
+
+    for (int i = (int) InstructionSet::numInstructionSets - 1; i > 0; --i)
+    {
+        const auto instructionSet = static_cast<InstructionSet>(i);
+
+        if (isSupported(instructionSet))
+            return instructionSet;
+    }
+
+    return InstructionSet::scalar;
+}
+
+const KernelTable& getKernels(InstructionSet instructionSet) {
+    jassert(isSupported(instructionSet));
+
+    switch (instructionSet)
+    {
+#if JUCE_INTEL
+    case InstructionSet::sse41:
+        return sse41Kernels;
+    case InstructionSet::avx2:
+        return avx2Kernels;
+    case InstructionSet::avx512:
+        return avx512Kernels;
+#endif
+    default:
+        return scalarKernels;
+    }
+}
+
+float fastTanh(float x) {
+    return scalar::fastTanh(scalar::broadcast(x)).v;
+}
+
+}
@@ -0,0 +1,188 @@
+/*
+  ==============================================================================
+
+    DSPKernels.h
+    Created: 19 Oct 2026 11:02:47am
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Block processing kernels for the distortion, filter and envelope stages.
+// Every kernel is compiled once per instruction set and the best one the CPU
+// supports is picked at runtime. Set the IGNITION_ISA environment variable
+// to scalar, sse41, avx2 or avx512 to force a specific variant.
+namespace DSPKernels
+{
+	enum class InstructionSet {
+		scalar,
+		sse41,
+		avx2,
+		avx512,
+		numInstructionSets
+	};
+
+	// Per channel state of the TPT state variable filter. The kernels only touch
+	// s1 and s2, bp is the saturating mode's starting guess for the next sample.
+	struct FilterState {
+		float s1 = 0.0f;
+		float s2 = 0.0f;
+		float bp = 0.0f;
+	};
+
+	// Tube and Fuzz sampled for the cheapest shaping, built once by DSPTables.
+	// Both cover [0, shaperTableRange] in shaperTableSize steps.
+	static constexpr int shaperTableSize = 2048;
+	static constexpr float shaperTableRange = 16.0f;
+
+	struct ShaperTables {
+		const float* tanh; // tanh(u), shaperTableSize + 1 points
+		const float* fuzz; // 1 - exp(-u), shaperTableSize + 1 points
+	};
+
+	// Up to degree 15, enough for 8x oversampling without aliasing
+	static constexpr int maxChebyshevCoefficients = 16;
+
+	// Past stereo, channels are packed into groups of laneGroupSize interleaved
+	// lanes, so the recursive filters run one channel per SIMD lane
+	static constexpr int maxLaneGroupSize = 8;
+
+	// The curves the fused chain has loops for, every distort variant but the tables
+	enum class ChainShaper {
+		hardClip,
+		tube,
+		tubeFast,
+		fuzz,
+		fuzzFast,
+		rectify,
+		numChainShapers
+	};
+
+	// Everything the fused chain reads. A filter that's off is never touched, and
+	// without modulated only the first g, h and drive are read, then held.
+	struct ChainSettings {
+		bool preFilter = false;
+		bool postFilter = false;
+		bool modulated = false;
+		ChainShaper shaper = ChainShaper::hardClip;
+
+		FilterState* preState = nullptr;  // laneGroupSize of them
+		const float* preG = nullptr;      // one per frame, shared by every lane
+		const float* preH = nullptr;
+		float preR2 = 0.0f;
+
+		FilterState* postState = nullptr;
+		const float* postG = nullptr;
+		const float* postH = nullptr;
+		float postR2 = 0.0f;
+
+		const float* drive = nullptr;     // one per frame
+	};
+
+	// The Diode algorithm's circuit at one sample rate, worked out by DistortionEngine.
+	// The root terms are for the port the diodes see.
+	struct DiodeClipper {
+		float sourceShare;              // share of the source wave at the diodes' port
+		float rootRIs, rootOffset;      // R Is, and log(R Is / Vt) + R Is / Vt
+		float thermalVoltage;
+	};
+
+	struct KernelTable {
+		InstructionSet instructionSet;
+		const char* name;
+
+		// Channels per lane group, 4 or 8
+		int laneGroupSize;
+
+		// Applies a distortion algorithm in place, drive holds one value per sample.
+		// Downsample is handled by the Decimator and its quantize kernel instead.
+		// Without exact, Tube and Fuzz use cheaper tanh and exp approximations.
+		void (*distort)(int algorithm, bool exact, float* data, const float* drive, int numSamples);
+
+		// Same as distort with Tube and Fuzz interpolated from tables, the cheapest of the three
+		void (*distortTable)(int algorithm, const ShaperTables& tables, float* data, const float* drive, int numSamples);
+
+		// Sum of coefficients[k] * T_k(x) in place, with x clamped to [-1, 1]. Even samples
+		// use evenCoefficients and odd ones oddCoefficients, so interleaved mid/side lanes
+		// can each have their own. Pass the same set twice for plain channels.
+		void (*chebyshev)(const float* evenCoefficients, const float* oddCoefficients, int numCoefficients, float* data, int numSamples);
+
+		// Rounds to numSteps levels per unit, stepSize is 1 / numSteps
+		void (*quantize)(float* data, float numSteps, float stepSize, int numSamples);
+
+		// Diode clipper in place over frames of numLanes interleaved lanes, drive holds one
+		// value per lane per frame. state holds two capacitor waves per lane, the clipper's
+		// and its makeup circuit's, side by side. Each lane is a recursion of its own, so
+		// the lanes are what runs side by side.
+		void (*diodeClipper)(const DiodeClipper& circuit, float* state, float* frames, const float* drive, int numLanes, int numFrames);
+
+		// Peak detects across channels and runs the attack/release smoother.
+		// Returns the envelope after the last sample.
+		float (*envelope)(const float* const* channels, int numChannels, float* envelopeOut, int numSamples,
+		                  float envelope, float attackCoef, float releaseCoef, float gate);
+
+		// Lowpass TPT coefficients for a block of cutoff frequencies in Hz
+		void (*filterCoefficients)(const float* cutoff, float* g, float* h, float R2, float sampleRate, int numSamples);
+
+		// Lowpass TPT filter in place with per sample coefficients
+		void (*filterLowpass)(FilterState& state, float* data, const float* g, const float* h, float R2, int numSamples);
+
+		// Same as filterLowpass over interleaved frames, state points at two filter states
+		void (*filterLowpassStereo)(FilterState* state, float* data, const float* g, const float* h, float R2, int numFrames);
+
+		// Same as filterLowpass over frames of laneGroupSize lanes, state points at that many
+		// filter states. Every lane uses the same g and h, one per frame.
+		void (*filterLowpassLanes)(FilterState* state, float* frames, const float* g, const float* h, float R2, int numFrames);
+
+		// Pre-filter, curve and post-filter over frames of laneGroupSize lanes in one pass, so the
+		// two filter recursions overlap instead of waiting on each other. Every combination of
+		// settings has its own loop, picked once per call.
+		void (*chainLanes)(const ChainSettings& settings, float* frames, int numFrames);
+
+		// out = a0 b0 a1 b1 ...
+		void (*interleave)(const float* a, const float* b, float* out, int numFrames);
+
+		// Up to laneGroupSize channels into frames of laneGroupSize lanes, lanes past
+		// numChannels are zeroed. unpackLanes writes back the first numChannels lanes.
+		void (*packLanes)(const float* const* channels, int numChannels, float* frames, int numFrames);
+		void (*unpackLanes)(const float* frames, float* const* channels, int numChannels, int numFrames);
+
+		// Left/right into interleaved mid/side frames, and back
+		void (*encodeMidSide)(const float* left, const float* right, float* out, int numFrames);
+		void (*decodeMidSide)(const float* in, float* left, float* right, int numFrames);
+
+		// decodeMidSide and mixModulated in one pass
+		void (*decodeMidSideMix)(const float* in, const float* dryLeft, const float* dryRight, float* left, float* right,
+		                         const float* mix, int numFrames);
+
+		// wet = dry + mix * (wet - dry)
+		void (*mix)(float* wet, const float* dry, float mix, int numSamples);
+
+		// Same as mix, with one mix amount per sample
+		void (*mixModulated)(float* wet, const float* dry, const float* mix, int numSamples);
+
+		// Largest magnitude and sum of squares over a block, for the level meters
+		void (*levels)(const float* data, int numSamples, float& peak, float& sumOfSquares);
+
+		// Largest magnitude out of a polyphase FIR: for every i < numSamples and every phase p,
+		// the sum over k of coefficients[p * numTaps + k] * data[i + k]. Reads numSamples + numTaps - 1 samples.
+		float (*polyphasePeak)(const float* data, const float* coefficients, int numPhases, int numTaps, int numSamples);
+	};
+
+	bool isSupported(InstructionSet instructionSet);
+
+	// The widest instruction set this CPU supports, or the one forced by IGNITION_ISA
+	InstructionSet selectInstructionSet();
+
+	const KernelTable& getKernels(InstructionSet instructionSet);
+
+	const char* getName(InstructionSet instructionSet);
+
+	// The scalar kernels' tanh() approximation, for code outside the kernels
+	// that has to match what they compute
+	float fastTanh(float x);
+}
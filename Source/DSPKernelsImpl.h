@@ -0,0 +1,1199 @@
+/*
+  ==============================================================================
+
+    DSPKernelsImpl.h
+    Created: 19 Oct 2026 11:02:47am
+    Author:  blues
+
+    Included once per instruction set by DSPKernels.cpp, inside its own
+    namespace and with the matching target options active. Don't include
+    this anywhere else, and don't add includes to it.
+
+  ==============================================================================
+*/
+
+//==============================================================================
+// Vector type for this instruction set
+
+#if IGNITION_KERNEL_ISA == 0 // scalar
+
+struct Vec { static constexpr int size = 1; float v; };
+using Mask = bool;
+
+inline Vec load(const float* p) { return { *p }; }
+inline void store(float* p, Vec a) { *p = a.v; }
+inline Vec broadcast(float x) { return { x }; }
+inline Vec operator+(Vec a, Vec b) { return { a.v + b.v }; }
+inline Vec operator-(Vec a, Vec b) { return { a.v - b.v }; }
+inline Vec operator*(Vec a, Vec b) { return { a.v * b.v }; }
+inline Vec operator/(Vec a, Vec b) { return { a.v / b.v }; }
+inline Vec mulAdd(Vec a, Vec b, Vec c) { return { a.v * b.v + c.v }; }
+inline Vec min(Vec a, Vec b) { return { a.v < b.v ? a.v : b.v }; }
+inline Vec max(Vec a, Vec b) { return { a.v > b.v ? a.v : b.v }; }
+inline Vec abs(Vec a) { return { std::abs(a.v) }; }
+inline Vec floor(Vec a) { return { std::floor(a.v) }; }
+inline Vec copySign(Vec magnitude, Vec sign) { return { std::copysign(magnitude.v, sign.v) }; }
+inline Mask greaterThan(Vec a, Vec b) { return a.v > b.v; }
+inline Vec select(Mask m, Vec a, Vec b) { return m ? a : b; }
+inline Vec pow2i(Vec n) { return { std::ldexp(1.0f, (int) n.v) }; }
+
+// floor(log2(a)), and a scaled into [1, 2) by the same power of two. Positive normal a only.
+inline Vec getExponent(Vec a) {
+	uint32_t bits;
+	std::memcpy(&bits, &a.v, sizeof(bits));
+	return { (float) ((int) (bits >> 23) - 127) };
+}
+inline Vec getMantissa(Vec a) {
+	uint32_t bits;
+	std::memcpy(&bits, &a.v, sizeof(bits));
+	bits = (bits & 0x007fffffu) | 0x3f800000u;
+
+	float m;
+	std::memcpy(&m, &bits, sizeof(m));
+	return { m };
+}
+inline Vec gather(const float* table, Vec index) { return { table[(int) index.v] }; }
+
+// a0 b0 a1 b1 ... into 2 * size floats, and back
+inline void storeInterleaved(float* p, Vec a, Vec b) { p[0] = a.v; p[1] = b.v; }
+inline void loadInterleaved(const float* p, Vec& a, Vec& b) { a.v = p[0]; b.v = p[1]; }
+
+#elif IGNITION_KERNEL_ISA == 1 // SSE4.1
+
+struct Vec { static constexpr int size = 4; __m128 v; };
+using Mask = __m128;
+
+inline Vec load(const float* p) { return { _mm_loadu_ps(p) }; }
+inline void store(float* p, Vec a) { _mm_storeu_ps(p, a.v); }
+inline Vec broadcast(float x) { return { _mm_set1_ps(x) }; }
+inline Vec operator+(Vec a, Vec b) { return { _mm_add_ps(a.v, b.v) }; }
+inline Vec operator-(Vec a, Vec b) { return { _mm_sub_ps(a.v, b.v) }; }
+inline Vec operator*(Vec a, Vec b) { return { _mm_mul_ps(a.v, b.v) }; }
+inline Vec operator/(Vec a, Vec b) { return { _mm_div_ps(a.v, b.v) }; }
+inline Vec mulAdd(Vec a, Vec b, Vec c) { return { _mm_add_ps(_mm_mul_ps(a.v, b.v), c.v) }; }
+inline Vec min(Vec a, Vec b) { return { _mm_min_ps(a.v, b.v) }; }
+inline Vec max(Vec a, Vec b) { return { _mm_max_ps(a.v, b.v) }; }
+inline Vec abs(Vec a) { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v) }; }
+inline Vec floor(Vec a) { return { _mm_floor_ps(a.v) }; }
+inline Vec copySign(Vec magnitude, Vec sign) {
+	const __m128 signBit = _mm_set1_ps(-0.0f);
+	return { _mm_or_ps(_mm_andnot_ps(signBit, magnitude.v), _mm_and_ps(signBit, sign.v)) };
+}
+inline Mask greaterThan(Vec a, Vec b) { return _mm_cmpgt_ps(a.v, b.v); }
+inline Vec select(Mask m, Vec a, Vec b) { return { _mm_blendv_ps(b.v, a.v, m) }; }
+inline Vec pow2i(Vec n) {
+	const __m128i e = _mm_add_epi32(_mm_cvtps_epi32(n.v), _mm_set1_epi32(127));
+	return { _mm_castsi128_ps(_mm_slli_epi32(e, 23)) };
+}
+inline Vec getExponent(Vec a) {
+	const __m128i e = _mm_srli_epi32(_mm_castps_si128(a.v), 23);
+	return { _mm_cvtepi32_ps(_mm_sub_epi32(e, _mm_set1_epi32(127))) };
+}
+inline Vec getMantissa(Vec a) {
+	return { _mm_or_ps(_mm_and_ps(a.v, _mm_castsi128_ps(_mm_set1_epi32(0x007fffff))), _mm_set1_ps(1.0f)) };
+}
+inline Vec gather(const float* table, Vec index) {
+	const __m128i i = _mm_cvttps_epi32(index.v);
+	return { _mm_set_ps(table[_mm_extract_epi32(i, 3)], table[_mm_extract_epi32(i, 2)],
+	                    table[_mm_extract_epi32(i, 1)], table[_mm_extract_epi32(i, 0)]) };
+}
+
+inline void storeInterleaved(float* p, Vec a, Vec b) {
+	_mm_storeu_ps(p, _mm_unpacklo_ps(a.v, b.v));
+	_mm_storeu_ps(p + 4, _mm_unpackhi_ps(a.v, b.v));
+}
+inline void loadInterleaved(const float* p, Vec& a, Vec& b) {
+	const __m128 x = _mm_loadu_ps(p);
+	const __m128 y = _mm_loadu_ps(p + 4);
+	a.v = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+	b.v = _mm_shuffle_ps(x, y, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+#elif IGNITION_KERNEL_ISA == 2 // AVX2 + FMA
+
+struct Vec { static constexpr int size = 8; __m256 v; };
+using Mask = __m256;
+
+inline Vec load(const float* p) { return { _mm256_loadu_ps(p) }; }
+inline void store(float* p, Vec a) { _mm256_storeu_ps(p, a.v); }
+inline Vec broadcast(float x) { return { _mm256_set1_ps(x) }; }
+inline Vec operator+(Vec a, Vec b) { return { _mm256_add_ps(a.v, b.v) }; }
+inline Vec operator-(Vec a, Vec b) { return { _mm256_sub_ps(a.v, b.v) }; }
+inline Vec operator*(Vec a, Vec b) { return { _mm256_mul_ps(a.v, b.v) }; }
+inline Vec operator/(Vec a, Vec b) { return { _mm256_div_ps(a.v, b.v) }; }
+inline Vec mulAdd(Vec a, Vec b, Vec c) { return { _mm256_fmadd_ps(a.v, b.v, c.v) }; }
+inline Vec min(Vec a, Vec b) { return { _mm256_min_ps(a.v, b.v) }; }
+inline Vec max(Vec a, Vec b) { return { _mm256_max_ps(a.v, b.v) }; }
+inline Vec abs(Vec a) { return { _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v) }; }
+inline Vec floor(Vec a) { return { _mm256_floor_ps(a.v) }; }
+inline Vec copySign(Vec magnitude, Vec sign) {
+	const __m256 signBit = _mm256_set1_ps(-0.0f);
+	return { _mm256_or_ps(_mm256_andnot_ps(signBit, magnitude.v), _mm256_and_ps(signBit, sign.v)) };
+}
+inline Mask greaterThan(Vec a, Vec b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ); }
+inline Vec select(Mask m, Vec a, Vec b) { return { _mm256_blendv_ps(b.v, a.v, m) }; }
+inline Vec pow2i(Vec n) {
+	const __m256i e = _mm256_add_epi32(_mm256_cvtps_epi32(n.v), _mm256_set1_epi32(127));
+	return { _mm256_castsi256_ps(_mm256_slli_epi32(e, 23)) };
+}
+inline Vec getExponent(Vec a) {
+	const __m256i e = _mm256_srli_epi32(_mm256_castps_si256(a.v), 23);
+	return { _mm256_cvtepi32_ps(_mm256_sub_epi32(e, _mm256_set1_epi32(127))) };
+}
+inline Vec getMantissa(Vec a) {
+	return { _mm256_or_ps(_mm256_and_ps(a.v, _mm256_castsi256_ps(_mm256_set1_epi32(0x007fffff))), _mm256_set1_ps(1.0f)) };
+}
+inline Vec gather(const float* table, Vec index) { return { _mm256_i32gather_ps(table, _mm256_cvttps_epi32(index.v), 4) }; }
+
+// unpack works inside each 128 bit half, so the halves get swapped back into order
+inline void storeInterleaved(float* p, Vec a, Vec b) {
+	const __m256 lo = _mm256_unpacklo_ps(a.v, b.v);
+	const __m256 hi = _mm256_unpackhi_ps(a.v, b.v);
+	_mm256_storeu_ps(p, _mm256_permute2f128_ps(lo, hi, 0x20));
+	_mm256_storeu_ps(p + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+}
+inline void loadInterleaved(const float* p, Vec& a, Vec& b) {
+	const __m256 x = _mm256_loadu_ps(p);
+	const __m256 y = _mm256_loadu_ps(p + 8);
+	const __m256 lo = _mm256_permute2f128_ps(x, y, 0x20);
+	const __m256 hi = _mm256_permute2f128_ps(x, y, 0x31);
+	a.v = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+	b.v = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+#elif IGNITION_KERNEL_ISA == 3 // AVX-512F
+
+struct Vec { static constexpr int size = 16; __m512 v; };
+using Mask = __mmask16;
+
+inline Vec load(const float* p) { return { _mm512_loadu_ps(p) }; }
+inline void store(float* p, Vec a) { _mm512_storeu_ps(p, a.v); }
+inline Vec broadcast(float x) { return { _mm512_set1_ps(x) }; }
+inline Vec operator+(Vec a, Vec b) { return { _mm512_add_ps(a.v, b.v) }; }
+inline Vec operator-(Vec a, Vec b) { return { _mm512_sub_ps(a.v, b.v) }; }
+inline Vec operator*(Vec a, Vec b) { return { _mm512_mul_ps(a.v, b.v) }; }
+inline Vec operator/(Vec a, Vec b) { return { _mm512_div_ps(a.v, b.v) }; }
+inline Vec mulAdd(Vec a, Vec b, Vec c) { return { _mm512_fmadd_ps(a.v, b.v, c.v) }; }
+inline Vec min(Vec a, Vec b) { return { _mm512_min_ps(a.v, b.v) }; }
+inline Vec max(Vec a, Vec b) { return { _mm512_max_ps(a.v, b.v) }; }
+inline Vec abs(Vec a) {
+	return { _mm512_castsi512_ps(_mm512_and_epi32(_mm512_castps_si512(a.v), _mm512_set1_epi32(0x7fffffff))) };
+}
+inline Vec floor(Vec a) { return { _mm512_roundscale_ps(a.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC) }; }
+inline Vec copySign(Vec magnitude, Vec sign) {
+	const __m512i signBit = _mm512_set1_epi32((int) 0x80000000);
+	const __m512i m = _mm512_andnot_epi32(signBit, _mm512_castps_si512(magnitude.v));
+	const __m512i s = _mm512_and_epi32(signBit, _mm512_castps_si512(sign.v));
+	return { _mm512_castsi512_ps(_mm512_or_epi32(m, s)) };
+}
+inline Mask greaterThan(Vec a, Vec b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ); }
+inline Vec select(Mask m, Vec a, Vec b) { return { _mm512_mask_blend_ps(m, b.v, a.v) }; }
+inline Vec pow2i(Vec n) {
+	const __m512i e = _mm512_add_epi32(_mm512_cvtps_epi32(n.v), _mm512_set1_epi32(127));
+	return { _mm512_castsi512_ps(_mm512_slli_epi32(e, 23)) };
+}
+inline Vec getExponent(Vec a) {
+	const __m512i e = _mm512_srli_epi32(_mm512_castps_si512(a.v), 23);
+	return { _mm512_cvtepi32_ps(_mm512_sub_epi32(e, _mm512_set1_epi32(127))) };
+}
+inline Vec getMantissa(Vec a) {
+	const __m512i m = _mm512_and_epi32(_mm512_castps_si512(a.v), _mm512_set1_epi32(0x007fffff));
+	return { _mm512_castsi512_ps(_mm512_or_epi32(m, _mm512_castps_si512(_mm512_set1_ps(1.0f)))) };
+}
+inline Vec gather(const float* table, Vec index) { return { _mm512_i32gather_ps(_mm512_cvttps_epi32(index.v), table, 4) }; }
+
+inline void storeInterleaved(float* p, Vec a, Vec b) {
+	const __m512i lo = _mm512_set_epi32(23, 7, 22, 6, 21, 5, 20, 4, 19, 3, 18, 2, 17, 1, 16, 0);
+	const __m512i hi = _mm512_set_epi32(31, 15, 30, 14, 29, 13, 28, 12, 27, 11, 26, 10, 25, 9, 24, 8);
+	_mm512_storeu_ps(p, _mm512_permutex2var_ps(a.v, lo, b.v));
+	_mm512_storeu_ps(p + 16, _mm512_permutex2var_ps(a.v, hi, b.v));
+}
+inline void loadInterleaved(const float* p, Vec& a, Vec& b) {
+	const __m512i even = _mm512_set_epi32(30, 28, 26, 24, 22, 20, 18, 16, 14, 12, 10, 8, 6, 4, 2, 0);
+	const __m512i odd = _mm512_set_epi32(31, 29, 27, 25, 23, 21, 19, 17, 15, 13, 11, 9, 7, 5, 3, 1);
+	const __m512 x = _mm512_loadu_ps(p);
+	const __m512 y = _mm512_loadu_ps(p + 16);
+	a.v = _mm512_permutex2var_ps(x, even, y);
+	b.v = _mm512_permutex2var_ps(x, odd, y);
+}
+
+#endif
+
+//==============================================================================
+// Two lanes, for running a recursion over interleaved mid/side frames
+
+#if IGNITION_KERNEL_ISA == 0
+
+struct Pair { float a, b; };
+
+inline Pair loadPair(const float* p) { return { p[0], p[1] }; }
+inline void storePair(float* p, Pair x) { p[0] = x.a; p[1] = x.b; }
+inline Pair makePair(float a, float b) { return { a, b }; }
+inline Pair operator+(Pair x, Pair y) { return { x.a + y.a, x.b + y.b }; }
+inline Pair operator-(Pair x, Pair y) { return { x.a - y.a, x.b - y.b }; }
+inline Pair operator*(Pair x, Pair y) { return { x.a * y.a, x.b * y.b }; }
+inline float lane0(Pair x) { return x.a; }
+inline float lane1(Pair x) { return x.b; }
+
+#else
+
+// The low half of an SSE register, every x86 instruction set here has it
+struct Pair { __m128 v; };
+
+inline Pair loadPair(const float* p) { return { _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(p))) }; }
+inline void storePair(float* p, Pair x) { _mm_store_sd(reinterpret_cast<double*>(p), _mm_castps_pd(x.v)); }
+inline Pair makePair(float a, float b) { return { _mm_setr_ps(a, b, 0.0f, 0.0f) }; }
+inline Pair operator+(Pair x, Pair y) { return { _mm_add_ps(x.v, y.v) }; }
+inline Pair operator-(Pair x, Pair y) { return { _mm_sub_ps(x.v, y.v) }; }
+inline Pair operator*(Pair x, Pair y) { return { _mm_mul_ps(x.v, y.v) }; }
+inline float lane0(Pair x) { return _mm_cvtss_f32(x.v); }
+inline float lane1(Pair x) { return _mm_cvtss_f32(_mm_shuffle_ps(x.v, x.v, _MM_SHUFFLE(1, 1, 1, 1))); }
+
+#endif
+
+//==============================================================================
+// One channel per lane, for running a recursion over packed channel groups.
+// AVX-512 sticks to eight lanes, sixteen would leave most of them empty for
+// anything short of the largest layouts.
+
+#if IGNITION_KERNEL_ISA == 0
+
+constexpr int laneGroupSize = 4;
+
+struct Lanes { float v[laneGroupSize]; };
+
+inline Lanes loadLanes(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+inline void storeLanes(float* p, Lanes x) { for (int j = 0; j < laneGroupSize; ++j) p[j] = x.v[j]; }
+inline Lanes broadcastLanes(float a) { return { { a, a, a, a } }; }
+inline Lanes operator+(Lanes x, Lanes y) { for (int j = 0; j < laneGroupSize; ++j) x.v[j] += y.v[j]; return x; }
+inline Lanes operator-(Lanes x, Lanes y) { for (int j = 0; j < laneGroupSize; ++j) x.v[j] -= y.v[j]; return x; }
+inline Lanes operator*(Lanes x, Lanes y) { for (int j = 0; j < laneGroupSize; ++j) x.v[j] *= y.v[j]; return x; }
+
+#elif IGNITION_KERNEL_ISA == 1
+
+constexpr int laneGroupSize = 4;
+
+struct Lanes { __m128 v; };
+
+inline Lanes loadLanes(const float* p) { return { _mm_loadu_ps(p) }; }
+inline void storeLanes(float* p, Lanes x) { _mm_storeu_ps(p, x.v); }
+inline Lanes broadcastLanes(float a) { return { _mm_set1_ps(a) }; }
+inline Lanes operator+(Lanes x, Lanes y) { return { _mm_add_ps(x.v, y.v) }; }
+inline Lanes operator-(Lanes x, Lanes y) { return { _mm_sub_ps(x.v, y.v) }; }
+inline Lanes operator*(Lanes x, Lanes y) { return { _mm_mul_ps(x.v, y.v) }; }
+
+#else
+
+constexpr int laneGroupSize = 8;
+
+struct Lanes { __m256 v; };
+
+inline Lanes loadLanes(const float* p) { return { _mm256_loadu_ps(p) }; }
+inline void storeLanes(float* p, Lanes x) { _mm256_storeu_ps(p, x.v); }
+inline Lanes broadcastLanes(float a) { return { _mm256_set1_ps(a) }; }
+inline Lanes operator+(Lanes x, Lanes y) { return { _mm256_add_ps(x.v, y.v) }; }
+inline Lanes operator-(Lanes x, Lanes y) { return { _mm256_sub_ps(x.v, y.v) }; }
+inline Lanes operator*(Lanes x, Lanes y) { return { _mm256_mul_ps(x.v, y.v) }; }
+
+#endif
+
+//==============================================================================
+// Math shared by every instruction set
+
+// Cephes expf, accurate to about 1 ulp
+inline Vec exp(Vec x) {
+	x = min(max(x, broadcast(-87.0f)), broadcast(88.0f));
+
+	const Vec n = floor(mulAdd(x, broadcast(1.44269504088896341f), broadcast(0.5f)));
+	Vec r = x - n * broadcast(0.693359375f);
+	r = r - n * broadcast(-2.12194440e-4f);
+
+	Vec y = broadcast(1.9875691500E-4f);
+	y = mulAdd(y, r, broadcast(1.3981999507E-3f));
+	y = mulAdd(y, r, broadcast(8.3334519073E-3f));
+	y = mulAdd(y, r, broadcast(4.1665795894E-2f));
+	y = mulAdd(y, r, broadcast(1.6666665459E-1f));
+	y = mulAdd(y, r, broadcast(5.0000001201E-1f));
+	y = mulAdd(y, r * r, r + broadcast(1.0f));
+
+	return y * pow2i(n);
+}
+
+// Cephes tanhf, polynomial for small arguments and exp() for the rest
+inline Vec tanh(Vec x) {
+	const Vec ax = abs(x);
+	const Vec z = x * x;
+
+	Vec p = broadcast(-5.70498872745E-3f);
+	p = mulAdd(p, z, broadcast(2.06390887954E-2f));
+	p = mulAdd(p, z, broadcast(-5.37397155531E-2f));
+	p = mulAdd(p, z, broadcast(1.33314422036E-1f));
+	p = mulAdd(p, z, broadcast(-3.33332819422E-1f));
+	const Vec small = mulAdd(p * z, x, x);
+
+	const Vec one = broadcast(1.0f);
+	const Vec large = copySign(one - broadcast(2.0f) / (exp(ax + ax) + one), x);
+
+	return select(greaterThan(ax, broadcast(0.625f)), large, small);
+}
+
+// Cheaper exp() for realtime, a single step range reduction and a degree 4
+// polynomial, good to about 4e-5 relative
+inline Vec fastExp(Vec x) {
+	x = min(max(x, broadcast(-87.0f)), broadcast(88.0f));
+
+	const Vec n = floor(mulAdd(x, broadcast(1.44269504088896341f), broadcast(0.5f)));
+	const Vec r = x - n * broadcast(0.693147180559945f);
+
+	Vec y = broadcast(1.0f / 24.0f);
+	y = mulAdd(y, r, broadcast(1.0f / 6.0f));
+	y = mulAdd(y, r, broadcast(0.5f));
+	y = mulAdd(y, r, broadcast(1.0f));
+	y = mulAdd(y, r, broadcast(1.0f));
+
+	return y * pow2i(n);
+}
+
+// Cheaper log() for x > 0, a cubic in the mantissa with nothing folded, good
+// to about 2.5e-4 absolute. Only meant for first guesses.
+inline Vec fastLog(Vec x) {
+	const Vec t = getMantissa(x) - broadcast(1.0f);
+
+	Vec y = broadcast(-0.07323740523185736f);
+	y = mulAdd(y, t, broadcast(0.25231858234181553f));
+	y = mulAdd(y, t, broadcast(-0.4857423674537693f));
+	y = mulAdd(y, t, broadcast(0.9995653689071055f));
+
+	return mulAdd(getExponent(x), broadcast(0.693147180559945f), y * t);
+}
+
+// Cheaper tanh() for realtime, a 7/6 Pade approximant clamped to +-1, within
+// about 2e-4 of the real thing
+inline Vec fastTanh(Vec x) {
+	const Vec z = x * x;
+
+	Vec p = z + broadcast(378.0f);
+	p = mulAdd(p, z, broadcast(17325.0f));
+	p = mulAdd(p, z, broadcast(135135.0f));
+
+	Vec q = broadcast(28.0f);
+	q = mulAdd(q, z, broadcast(3150.0f));
+	q = mulAdd(q, z, broadcast(62370.0f));
+	q = mulAdd(q, z, broadcast(135135.0f));
+
+	return min(max((x * p) / q, broadcast(-1.0f)), broadcast(1.0f));
+}
+
+// tan() for the filter prewarp, valid for 0 <= x < pi / 2
+inline Vec tanPrewarp(Vec x) {
+	const Vec z = x * x;
+
+	Vec s = broadcast(1.0f / 6227020800.0f);
+	s = mulAdd(s, z, broadcast(-1.0f / 39916800.0f));
+	s = mulAdd(s, z, broadcast(1.0f / 362880.0f));
+	s = mulAdd(s, z, broadcast(-1.0f / 5040.0f));
+	s = mulAdd(s, z, broadcast(1.0f / 120.0f));
+	s = mulAdd(s, z, broadcast(-1.0f / 6.0f));
+	s = mulAdd(s, z, broadcast(1.0f));
+
+	Vec c = broadcast(-1.0f / 87178291200.0f);
+	c = mulAdd(c, z, broadcast(1.0f / 479001600.0f));
+	c = mulAdd(c, z, broadcast(-1.0f / 3628800.0f));
+	c = mulAdd(c, z, broadcast(1.0f / 40320.0f));
+	c = mulAdd(c, z, broadcast(-1.0f / 720.0f));
+	c = mulAdd(c, z, broadcast(1.0f / 24.0f));
+	c = mulAdd(c, z, broadcast(-0.5f));
+	c = mulAdd(c, z, broadcast(1.0f));
+
+	return (s * x) / c;
+}
+
+// Wright omega, the w with w + log(w) = x. D'Angelo et al.'s cubic for a first
+// guess up to 3 and the asymptotic series past it, then one Halley step on
+// w - exp(x - w). Good to about 1e-4 absolute over the whole range, no loop.
+inline Vec wrightOmega(Vec x) {
+	const Vec one = broadcast(1.0f);
+	const Vec lower = broadcast(-3.341459552768620f);
+	const Vec upper = broadcast(3.0f);
+
+	Vec w = broadcast(-1.314293149877800e-3f);
+	w = mulAdd(w, x, broadcast(4.775931364975583e-2f));
+	w = mulAdd(w, x, broadcast(3.631952663804445e-1f));
+	w = mulAdd(w, x, broadcast(6.313183464296682e-1f));
+
+	const Vec large = max(x, upper);
+	const Vec logLarge = fastLog(large);
+
+	w = select(greaterThan(x, upper), large - logLarge + logLarge / large, w);
+	w = select(greaterThan(lower, x), broadcast(0.0f), w);
+
+	const Vec e = fastExp(x - w);
+	const Vec f = w - e;
+	const Vec slope = e + one;
+
+	return w - f * slope / mulAdd(broadcast(0.5f) * f, e, slope * slope);
+}
+
+inline Vec roundHalfAway(Vec x) {
+	return copySign(floor(abs(x) + broadcast(0.5f)), x);
+}
+
+//==============================================================================
+// Distortion curves, matching DistortionEngine's scalar versions
+
+inline Vec hardClip(Vec x, Vec drive) {
+	return min(max(x * (drive + broadcast(1.0f)), broadcast(-1.0f)), broadcast(1.0f));
+}
+
+inline Vec tube(Vec x, Vec drive) {
+	return tanh(x * drive) / tanh(drive);
+}
+
+inline Vec fuzz(Vec x, Vec drive) {
+	const Vec one = broadcast(1.0f);
+	const Vec shaped = (one - exp(broadcast(0.0f) - abs(drive * x))) / (one - exp(broadcast(0.0f) - drive));
+	return copySign(shaped, x);
+}
+
+inline Vec tubeFast(Vec x, Vec drive) {
+	return fastTanh(x * drive) / fastTanh(drive);
+}
+
+inline Vec fuzzFast(Vec x, Vec drive) {
+	const Vec one = broadcast(1.0f);
+	const Vec shaped = (one - fastExp(broadcast(0.0f) - abs(drive * x))) / (one - fastExp(broadcast(0.0f) - drive));
+	return copySign(shaped, x);
+}
+
+inline Vec rectify(Vec x, Vec drive) {
+	return hardClip(abs(x), drive);
+}
+
+// Voltage across an antiparallel diode pair for the wave a arriving from a port
+// of resistance R, in Werner et al.'s closed form, which counts the reverse
+// biased diode as off. rIs is R * Is, offset is log(rIs / Vt) + rIs / Vt.
+inline Vec diodePairVoltage(Vec a, Vec rIs, Vec offset, Vec vt, Vec vtInverse) {
+	const Vec magnitude = abs(a);
+	return copySign(magnitude + rIs - vt * wrightOmega(mulAdd(magnitude, vtInverse, offset)), a);
+}
+
+// Linear interpolation into a shaper table, clamped to both ends of the range so
+// no drive, however it got here, can index outside the shared table
+inline Vec lookup(const float* table, Vec u) {
+	const Vec scaled = min(u * broadcast((float) shaperTableSize / shaperTableRange), broadcast((float) shaperTableSize));
+	const Vec position = max(scaled, broadcast(0.0f));
+	const Vec index = min(floor(position), broadcast((float) (shaperTableSize - 1)));
+
+	const Vec a = gather(table, index);
+	const Vec b = gather(table + 1, index);
+
+	return mulAdd(position - index, b - a, a);
+}
+
+inline Vec tubeTable(Vec x, Vec drive, const ShaperTables& tables) {
+	return copySign(lookup(tables.tanh, abs(x * drive)), x) / lookup(tables.tanh, drive);
+}
+
+inline Vec fuzzTable(Vec x, Vec drive, const ShaperTables& tables) {
+	return copySign(lookup(tables.fuzz, abs(x * drive)), x) / lookup(tables.fuzz, drive);
+}
+
+template <typename Shaper>
+void distortLoopWith(float* data, const float* drive, int numSamples, Shaper shaper) {
+	int i = 0;
+
+	for (; i + Vec::size <= numSamples; i += Vec::size)
+		store(data + i, shaper(load(data + i), load(drive + i)));
+
+	// Pad the tail out to a full vector so it goes through the same math
+	if (i < numSamples)
+	{
+		float x[Vec::size], d[Vec::size];
+		const int remaining = numSamples - i;
+
+		for (int j = 0; j < Vec::size; ++j)
+		{
+			x[j] = j < remaining ? data[i + j] : 0.0f;
+			d[j] = j < remaining ? drive[i + j] : 1.0f;
+		}
+
+		store(x, shaper(load(x), load(d)));
+
+		for (int j = 0; j < remaining; ++j)
+			data[i + j] = x[j];
+	}
+}
+
+template <Vec (*shaper)(Vec, Vec)>
+void distortLoop(float* data, const float* drive, int numSamples) {
+	distortLoopWith(data, drive, numSamples, [](Vec x, Vec d) { return shaper(x, d); });
+}
+
+//==============================================================================
+// Kernels
+
+void distortBlock(int algorithm, bool exact, float* data, const float* drive, int numSamples) {
+	switch (algorithm)
+	{
+	case 0:
+		distortLoop<hardClip>(data, drive, numSamples);
+		break;
+	case 1:
+		if (exact)
+			distortLoop<tube>(data, drive, numSamples);
+		else
+			distortLoop<tubeFast>(data, drive, numSamples);
+		break;
+	case 2:
+		if (exact)
+			distortLoop<fuzz>(data, drive, numSamples);
+		else
+			distortLoop<fuzzFast>(data, drive, numSamples);
+		break;
+	case 3:
+		distortLoop<rectify>(data, drive, numSamples);
+		break;
+	}
+}
+
+void distortTableBlock(int algorithm, const ShaperTables& tables, float* data, const float* drive, int numSamples) {
+	switch (algorithm)
+	{
+	case 1:
+		distortLoopWith(data, drive, numSamples, [&tables](Vec x, Vec d) { return tubeTable(x, d, tables); });
+		break;
+	case 2:
+		distortLoopWith(data, drive, numSamples, [&tables](Vec x, Vec d) { return fuzzTable(x, d, tables); });
+		break;
+	default:
+		// Hard Clip and Rectify are already cheaper than a table
+		distortBlock(algorithm, false, data, drive, numSamples);
+		break;
+	}
+}
+
+void chebyshevBlock(const float* evenCoefficients, const float* oddCoefficients, int numCoefficients, float* data, int numSamples) {
+	// Each coefficient spread over the lanes, for a vector starting on an even
+	// sample and on an odd one. Only the scalar version ever starts on an odd one.
+	float lanes[maxChebyshevCoefficients][2][Vec::size];
+
+	for (int k = 0; k < numCoefficients; ++k)
+		for (int parity = 0; parity < 2; ++parity)
+			for (int j = 0; j < Vec::size; ++j)
+				lanes[k][parity][j] = ((parity + j) % 2 == 0 ? evenCoefficients : oddCoefficients)[k];
+
+	// Clenshaw's recurrence, no branches and one multiply-add per coefficient
+	auto evaluate = [&](Vec x, int parity) {
+		x = min(max(x, broadcast(-1.0f)), broadcast(1.0f));
+
+		const Vec twoX = x + x;
+		Vec b1 = broadcast(0.0f), b2 = broadcast(0.0f);
+
+		for (int k = numCoefficients - 1; k > 0; --k)
+		{
+			const Vec b0 = mulAdd(twoX, b1, load(lanes[k][parity])) - b2;
+			b2 = b1;
+			b1 = b0;
+		}
+
+		return mulAdd(x, b1, load(lanes[0][parity])) - b2;
+	};
+
+	int i = 0;
+
+	for (; i + Vec::size <= numSamples; i += Vec::size)
+		store(data + i, evaluate(load(data + i), i & 1));
+
+	if (i < numSamples)
+	{
+		float x[Vec::size] = {};
+		const int remaining = numSamples - i;
+
+		std::copy(data + i, data + numSamples, x);
+		store(x, evaluate(load(x), i & 1));
+		std::copy(x, x + remaining, data + i);
+	}
+}
+
+void quantizeBlock(float* data, float numSteps, float stepSize, int numSamples) {
+	const Vec steps = broadcast(numSteps);
+	const Vec size = broadcast(stepSize);
+	int i = 0;
+
+	for (; i + Vec::size <= numSamples; i += Vec::size)
+		store(data + i, roundHalfAway(load(data + i) * steps) * size);
+
+	for (; i < numSamples; ++i)
+		data[i] = std::round(data[i] * numSteps) * stepSize;
+}
+
+void diodeClipperBlock(const DiodeClipper& circuit, float* state, float* frames, const float* drive, int numLanes, int numFrames) {
+	const Vec sourceShare = broadcast(circuit.sourceShare);
+	const Vec rootRIs = broadcast(circuit.rootRIs);
+	const Vec rootOffset = broadcast(circuit.rootOffset);
+	const Vec vt = broadcast(circuit.thermalVoltage);
+	const Vec vtInverse = broadcast(1.0f / circuit.thermalVoltage);
+
+	// Source and capacitor meet the diodes through a parallel adaptor, the capacitor's
+	// wave is its incident wave from the sample before
+	auto circuitStep = [&](Vec source, Vec& z) {
+		const Vec v = diodePairVoltage(mulAdd(source - z, sourceShare, z), rootRIs, rootOffset, vt, vtInverse);
+
+		z = v + v - z;
+		return v;
+	};
+
+	// Scaled by a copy of the circuit fed the drive alone, so x = 1 comes out at 1 like
+	// the other curves once it settles. Its capacitor lags a moving drive the same way,
+	// which keeps the output within full scale where a static makeup would overshoot.
+	auto step = [&](Vec x, Vec d, Vec& z, Vec& makeupZ) {
+		const Vec v = circuitStep(x * d, z);
+		return v / circuitStep(d, makeupZ);
+	};
+
+	// The recursion runs down each lane, so the lanes share a vector instead of
+	// the samples. A short group is padded out, with drive 1 to keep it finite.
+	for (int first = 0; first < numLanes; first += Vec::size)
+	{
+		const int width = juce::jmin(Vec::size, numLanes - first);
+		float x[Vec::size] = {}, d[Vec::size], z[Vec::size] = {}, makeupZ[Vec::size] = {};
+
+		std::fill(d, d + Vec::size, 1.0f);
+
+		for (int lane = 0; lane < width; ++lane)
+		{
+			z[lane] = state[2 * (first + lane)];
+			makeupZ[lane] = state[2 * (first + lane) + 1];
+		}
+
+		Vec zv = load(z);
+		Vec makeupZv = load(makeupZ);
+
+		if (width == Vec::size)
+		{
+			for (int i = 0; i < numFrames; ++i)
+			{
+				float* frame = frames + i * numLanes + first;
+				store(frame, step(load(frame), load(drive + i * numLanes + first), zv, makeupZv));
+			}
+		}
+		else
+		{
+			for (int i = 0; i < numFrames; ++i)
+			{
+				float* frame = frames + i * numLanes + first;
+
+				std::copy(frame, frame + width, x);
+				std::copy(drive + i * numLanes + first, drive + i * numLanes + first + width, d);
+
+				store(x, step(load(x), load(d), zv, makeupZv));
+				std::copy(x, x + width, frame);
+			}
+		}
+
+		store(z, zv);
+		store(makeupZ, makeupZv);
+
+		for (int lane = 0; lane < width; ++lane)
+		{
+			state[2 * (first + lane)] = z[lane];
+			state[2 * (first + lane) + 1] = makeupZ[lane];
+		}
+	}
+}
+
+float envelopeBlock(const float* const* channels, int numChannels, float* envelopeOut, int numSamples,
+                    float envelope, float attackCoef, float releaseCoef, float gate) {
+	int i = 0;
+
+	// Linked peak across channels
+	for (; i + Vec::size <= numSamples; i += Vec::size)
+	{
+		Vec peak = broadcast(0.0f);
+
+		for (int channel = 0; channel < numChannels; ++channel)
+			peak = max(peak, abs(load(channels[channel] + i)));
+
+		store(envelopeOut + i, peak);
+	}
+
+	for (; i < numSamples; ++i)
+	{
+		float peak = 0.0f;
+
+		for (int channel = 0; channel < numChannels; ++channel)
+			peak = std::max(peak, std::abs(channels[channel][i]));
+
+		envelopeOut[i] = peak;
+	}
+
+	// The smoother is recursive, so it stays scalar
+	for (i = 0; i < numSamples; ++i)
+	{
+		const float input = envelopeOut[i];
+		const float coef = (input > envelope && input > gate) ? attackCoef : releaseCoef;
+
+		envelope = coef * envelope + (1.0f - coef) * input;
+		envelopeOut[i] = envelope;
+	}
+
+	return envelope;
+}
+
+void filterCoefficientsBlock(const float* cutoff, float* g, float* h, float R2, float sampleRate, int numSamples) {
+	const Vec scale = broadcast(3.14159265358979f / sampleRate);
+	const Vec lowest = broadcast(0.0f);
+	const Vec highest = broadcast(1.5f); // just short of pi / 2, where tan() blows up
+	const Vec damping = broadcast(R2);
+	const Vec one = broadcast(1.0f);
+
+	int i = 0;
+
+	for (; i + Vec::size <= numSamples; i += Vec::size)
+	{
+		const Vec gv = tanPrewarp(min(max(load(cutoff + i) * scale, lowest), highest));
+
+		store(g + i, gv);
+		store(h + i, one / mulAdd(gv, gv + damping, one));
+	}
+
+	if (i < numSamples)
+	{
+		float c[Vec::size], gt[Vec::size], ht[Vec::size];
+		const int remaining = numSamples - i;
+
+		for (int j = 0; j < Vec::size; ++j)
+			c[j] = j < remaining ? cutoff[i + j] : 0.0f;
+
+		const Vec gv = tanPrewarp(min(max(load(c) * scale, lowest), highest));
+		store(gt, gv);
+		store(ht, one / mulAdd(gv, gv + damping, one));
+
+		for (int j = 0; j < remaining; ++j)
+		{
+			g[i + j] = gt[j];
+			h[i + j] = ht[j];
+		}
+	}
+}
+
+void filterLowpassBlock(FilterState& state, float* data, const float* g, const float* h, float R2, int numSamples) {
+	float s1 = state.s1;
+	float s2 = state.s2;
+
+	for (int i = 0; i < numSamples; ++i)
+	{
+		const float yHP = h[i] * (data[i] - s1 * (g[i] + R2) - s2);
+
+		const float yBP = yHP * g[i] + s1;
+		s1 = yHP * g[i] + yBP;
+
+		const float yLP = yBP * g[i] + s2;
+		s2 = yBP * g[i] + yLP;
+
+		data[i] = yLP;
+	}
+
+	state.s1 = s1;
+	state.s2 = s2;
+}
+
+void filterLowpassStereoBlock(FilterState* state, float* data, const float* g, const float* h, float R2, int numFrames) {
+	const Pair r2 = makePair(R2, R2);
+	Pair s1 = makePair(state[0].s1, state[1].s1);
+	Pair s2 = makePair(state[0].s2, state[1].s2);
+
+	for (int i = 0; i < numFrames * 2; i += 2)
+	{
+		const Pair gi = loadPair(g + i);
+		const Pair yHP = loadPair(h + i) * (loadPair(data + i) - s1 * (gi + r2) - s2);
+
+		const Pair yBP = yHP * gi + s1;
+		s1 = yHP * gi + yBP;
+
+		const Pair yLP = yBP * gi + s2;
+		s2 = yBP * gi + yLP;
+
+		storePair(data + i, yLP);
+	}
+
+	state[0] = { lane0(s1), lane0(s2) };
+	state[1] = { lane1(s1), lane1(s2) };
+}
+
+inline void loadLaneStates(const FilterState* state, Lanes& s1, Lanes& s2) {
+	float s1In[laneGroupSize], s2In[laneGroupSize];
+
+	for (int j = 0; j < laneGroupSize; ++j)
+	{
+		s1In[j] = state[j].s1;
+		s2In[j] = state[j].s2;
+	}
+
+	s1 = loadLanes(s1In);
+	s2 = loadLanes(s2In);
+}
+
+inline void storeLaneStates(FilterState* state, Lanes s1, Lanes s2) {
+	float s1Out[laneGroupSize], s2Out[laneGroupSize];
+
+	storeLanes(s1Out, s1);
+	storeLanes(s2Out, s2);
+
+	for (int j = 0; j < laneGroupSize; ++j)
+		state[j] = { s1Out[j], s2Out[j] };
+}
+
+inline Lanes lowpassLanes(Lanes x, Lanes g, Lanes h, Lanes r2, Lanes& s1, Lanes& s2) {
+	const Lanes yHP = h * (x - s1 * (g + r2) - s2);
+
+	const Lanes yBP = yHP * g + s1;
+	s1 = yHP * g + yBP;
+
+	const Lanes yLP = yBP * g + s2;
+	s2 = yBP * g + yLP;
+
+	return yLP;
+}
+
+void filterLowpassLanesBlock(FilterState* state, float* frames, const float* g, const float* h, float R2, int numFrames) {
+	const Lanes r2 = broadcastLanes(R2);
+	Lanes s1, s2;
+	loadLaneStates(state, s1, s2);
+
+	for (int i = 0; i < numFrames; ++i)
+	{
+		float* frame = frames + i * laneGroupSize;
+		storeLanes(frame, lowpassLanes(loadLanes(frame), broadcastLanes(g[i]), broadcastLanes(h[i]), r2, s1, s2));
+	}
+
+	storeLaneStates(state, s1, s2);
+}
+
+// A curve applied to one frame of lanes
+#if IGNITION_KERNEL_ISA == 0
+
+template <Vec (*shaper)(Vec, Vec)>
+inline Lanes shapeLanes(Lanes x, Lanes drive) {
+	for (int j = 0; j < laneGroupSize; ++j)
+		x.v[j] = shaper({ x.v[j] }, { drive.v[j] }).v;
+
+	return x;
+}
+
+#elif IGNITION_KERNEL_ISA == 3
+
+// The low half of a full vector, with the rest of it kept finite for the curves
+template <Vec (*shaper)(Vec, Vec)>
+inline Lanes shapeLanes(Lanes x, Lanes drive) {
+	const Vec wideX = { _mm512_castpd_ps(_mm512_insertf64x4(_mm512_setzero_pd(), _mm256_castps_pd(x.v), 0)) };
+	const Vec wideDrive = { _mm512_castpd_ps(_mm512_insertf64x4(_mm512_set1_pd(1.0), _mm256_castps_pd(drive.v), 0)) };
+
+	return { _mm512_castps512_ps256(shaper(wideX, wideDrive).v) };
+}
+
+#else
+
+// Lanes and Vec are the same register here
+template <Vec (*shaper)(Vec, Vec)>
+inline Lanes shapeLanes(Lanes x, Lanes drive) {
+	return { shaper({ x.v }, { drive.v }).v };
+}
+
+#endif
+
+// The stage flags are template arguments, so each instantiation is one straight
+// loop with the stages that are off compiled out
+template <bool preFilter, bool postFilter, bool modulated, Vec (*shaper)(Vec, Vec)>
+void chainLanesLoop(const ChainSettings& settings, float* frames, int numFrames) {
+	const Lanes preR2 = broadcastLanes(settings.preR2);
+	const Lanes postR2 = broadcastLanes(settings.postR2);
+
+	Lanes preS1, preS2, postS1, postS2;
+
+	if (preFilter)
+		loadLaneStates(settings.preState, preS1, preS2);
+
+	if (postFilter)
+		loadLaneStates(settings.postState, postS1, postS2);
+
+	Lanes preG = broadcastLanes(preFilter ? settings.preG[0] : 0.0f);
+	Lanes preH = broadcastLanes(preFilter ? settings.preH[0] : 0.0f);
+	Lanes postG = broadcastLanes(postFilter ? settings.postG[0] : 0.0f);
+	Lanes postH = broadcastLanes(postFilter ? settings.postH[0] : 0.0f);
+	Lanes drive = broadcastLanes(settings.drive[0]);
+
+	for (int i = 0; i < numFrames; ++i)
+	{
+		float* frame = frames + i * laneGroupSize;
+		Lanes x = loadLanes(frame);
+
+		if (modulated)
+		{
+			if (preFilter)
+			{
+				preG = broadcastLanes(settings.preG[i]);
+				preH = broadcastLanes(settings.preH[i]);
+			}
+
+			if (postFilter)
+			{
+				postG = broadcastLanes(settings.postG[i]);
+				postH = broadcastLanes(settings.postH[i]);
+			}
+
+			drive = broadcastLanes(settings.drive[i]);
+		}
+
+		if (preFilter)
+			x = lowpassLanes(x, preG, preH, preR2, preS1, preS2);
+
+		x = shapeLanes<shaper>(x, drive);
+
+		if (postFilter)
+			x = lowpassLanes(x, postG, postH, postR2, postS1, postS2);
+
+		storeLanes(frame, x);
+	}
+
+	if (preFilter)
+		storeLaneStates(settings.preState, preS1, preS2);
+
+	if (postFilter)
+		storeLaneStates(settings.postState, postS1, postS2);
+}
+
+using ChainLoop = void (*)(const ChainSettings&, float*, int);
+
+template <Vec (*shaper)(Vec, Vec)>
+struct ChainLoops {
+	// Indexed by preFilter + 2 * postFilter + 4 * modulated
+	static constexpr ChainLoop loops[8] = {
+		chainLanesLoop<false, false, false, shaper>, chainLanesLoop<true, false, false, shaper>,
+		chainLanesLoop<false, true, false, shaper>,  chainLanesLoop<true, true, false, shaper>,
+		chainLanesLoop<false, false, true, shaper>,  chainLanesLoop<true, false, true, shaper>,
+		chainLanesLoop<false, true, true, shaper>,   chainLanesLoop<true, true, true, shaper>
+	};
+};
+
+template <Vec (*shaper)(Vec, Vec)>
+constexpr ChainLoop ChainLoops<shaper>::loops[8];
+
+void chainLanesBlock(const ChainSettings& settings, float* frames, int numFrames) {
+	static const ChainLoop* const shaperLoops[] = {
+		ChainLoops<hardClip>::loops, ChainLoops<tube>::loops, ChainLoops<tubeFast>::loops,
+		ChainLoops<fuzz>::loops, ChainLoops<fuzzFast>::loops, ChainLoops<rectify>::loops
+	};
+
+	static_assert(sizeof(shaperLoops) / sizeof(shaperLoops[0]) == (size_t) ChainShaper::numChainShapers, "one row of loops per shaper");
+
+	const int index = (settings.preFilter ? 1 : 0) + (settings.postFilter ? 2 : 0) + (settings.modulated ? 4 : 0);
+	shaperLoops[(int) settings.shaper][index](settings, frames, numFrames);
+}
+
+void interleaveBlock(const float* a, const float* b, float* out, int numFrames) {
+	int i = 0;
+
+	for (; i + Vec::size <= numFrames; i += Vec::size)
+		storeInterleaved(out + 2 * i, load(a + i), load(b + i));
+
+	for (; i < numFrames; ++i)
+	{
+		out[2 * i] = a[i];
+		out[2 * i + 1] = b[i];
+	}
+}
+
+void packLanesBlock(const float* const* channels, int numChannels, float* frames, int numFrames) {
+	for (int i = 0; i < numFrames; ++i)
+	{
+		float* frame = frames + i * laneGroupSize;
+
+		for (int j = 0; j < numChannels; ++j)
+			frame[j] = channels[j][i];
+
+		for (int j = numChannels; j < laneGroupSize; ++j)
+			frame[j] = 0.0f;
+	}
+}
+
+void unpackLanesBlock(const float* frames, float* const* channels, int numChannels, int numFrames) {
+	for (int i = 0; i < numFrames; ++i)
+		for (int j = 0; j < numChannels; ++j)
+			channels[j][i] = frames[i * laneGroupSize + j];
+}
+
+void encodeMidSideBlock(const float* left, const float* right, float* out, int numFrames) {
+	const Vec half = broadcast(0.5f);
+	int i = 0;
+
+	for (; i + Vec::size <= numFrames; i += Vec::size)
+	{
+		const Vec l = load(left + i);
+		const Vec r = load(right + i);
+		storeInterleaved(out + 2 * i, (l + r) * half, (l - r) * half);
+	}
+
+	for (; i < numFrames; ++i)
+	{
+		out[2 * i] = (left[i] + right[i]) * 0.5f;
+		out[2 * i + 1] = (left[i] - right[i]) * 0.5f;
+	}
+}
+
+void decodeMidSideBlock(const float* in, float* left, float* right, int numFrames) {
+	int i = 0;
+
+	for (; i + Vec::size <= numFrames; i += Vec::size)
+	{
+		Vec m, s;
+		loadInterleaved(in + 2 * i, m, s);
+		store(left + i, m + s);
+		store(right + i, m - s);
+	}
+
+	for (; i < numFrames; ++i)
+	{
+		left[i] = in[2 * i] + in[2 * i + 1];
+		right[i] = in[2 * i] - in[2 * i + 1];
+	}
+}
+
+void decodeMidSideMixBlock(const float* in, const float* dryLeft, const float* dryRight, float* left, float* right,
+                           const float* mix, int numFrames) {
+	int i = 0;
+
+	for (; i + Vec::size <= numFrames; i += Vec::size)
+	{
+		Vec m, s;
+		loadInterleaved(in + 2 * i, m, s);
+
+		const Vec amount = load(mix + i);
+		const Vec dl = load(dryLeft + i);
+		const Vec dr = load(dryRight + i);
+		store(left + i, mulAdd(m + s - dl, amount, dl));
+		store(right + i, mulAdd(m - s - dr, amount, dr));
+	}
+
+	for (; i < numFrames; ++i)
+	{
+		const float m = in[2 * i];
+		const float s = in[2 * i + 1];
+		left[i] = dryLeft[i] + mix[i] * (m + s - dryLeft[i]);
+		right[i] = dryRight[i] + mix[i] * (m - s - dryRight[i]);
+	}
+}
+
+void mixBlock(float* wet, const float* dry, float mix, int numSamples) {
+	const Vec m = broadcast(mix);
+	int i = 0;
+
+	for (; i + Vec::size <= numSamples; i += Vec::size)
+	{
+		const Vec d = load(dry + i);
+		store(wet + i, mulAdd(load(wet + i) - d, m, d));
+	}
+
+	for (; i < numSamples; ++i)
+		wet[i] = dry[i] + mix * (wet[i] - dry[i]);
+}
+
+void mixModulatedBlock(float* wet, const float* dry, const float* mix, int numSamples) {
+	int i = 0;
+
+	for (; i + Vec::size <= numSamples; i += Vec::size)
+	{
+		const Vec d = load(dry + i);
+		store(wet + i, mulAdd(load(wet + i) - d, load(mix + i), d));
+	}
+
+	for (; i < numSamples; ++i)
+		wet[i] = dry[i] + mix[i] * (wet[i] - dry[i]);
+}
+
+inline float reduceMax(Vec a) {
+	float lanes[Vec::size];
+	store(lanes, a);
+
+	float result = lanes[0];
+
+	for (int j = 1; j < Vec::size; ++j)
+		result = lanes[j] > result ? lanes[j] : result;
+
+	return result;
+}
+
+inline float reduceSum(Vec a) {
+	float lanes[Vec::size];
+	store(lanes, a);
+
+	float result = 0.0f;
+
+	for (int j = 0; j < Vec::size; ++j)
+		result += lanes[j];
+
+	return result;
+}
+
+void levelsBlock(const float* data, int numSamples, float& peak, float& sumOfSquares) {
+	Vec peakV = broadcast(0.0f);
+	Vec sumV = broadcast(0.0f);
+	int i = 0;
+
+	for (; i + Vec::size <= numSamples; i += Vec::size)
+	{
+		const Vec x = load(data + i);
+		peakV = max(peakV, abs(x));
+		sumV = mulAdd(x, x, sumV);
+	}
+
+	float p = reduceMax(peakV);
+	float sum = reduceSum(sumV);
+
+	for (; i < numSamples; ++i)
+	{
+		p = std::abs(data[i]) > p ? std::abs(data[i]) : p;
+		sum += data[i] * data[i];
+	}
+
+	peak = p;
+	sumOfSquares = sum;
+}
+
+float polyphasePeakBlock(const float* data, const float* coefficients, int numPhases, int numTaps, int numSamples) {
+	Vec peakV = broadcast(0.0f);
+	int i = 0;
+
+	// Lanes are neighbouring outputs, so every tap is one unaligned load
+	for (; i + Vec::size <= numSamples; i += Vec::size)
+	{
+		for (int phase = 0; phase < numPhases; ++phase)
+		{
+			const float* c = coefficients + phase * numTaps;
+			Vec y = broadcast(0.0f);
+
+			for (int k = 0; k < numTaps; ++k)
+				y = mulAdd(load(data + i + k), broadcast(c[k]), y);
+
+			peakV = max(peakV, abs(y));
+		}
+	}
+
+	float peak = reduceMax(peakV);
+
+	for (; i < numSamples; ++i)
+	{
+		for (int phase = 0; phase < numPhases; ++phase)
+		{
+			const float* c = coefficients + phase * numTaps;
+			float y = 0.0f;
+
+			for (int k = 0; k < numTaps; ++k)
+				y += data[i + k] * c[k];
+
+			peak = std::abs(y) > peak ? std::abs(y) : peak;
+		}
+	}
+
+	return peak;
+}
@@ -0,0 +1,201 @@
+/*
+  ==============================================================================
+
+    DSPTables.cpp
+    Created: 19 Oct 2026 6:20:48pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#include "DSPTables.h"
+#include "Decimator.h"
+#include "Oversampler.h"
+#include "TraceRecorder.h"
+
+static int factorIndex(int factor) {
+    return factor == 2 ? 0 : (factor == 4 ? 1 : 2);
+}
+
+DSPTables::DSPTables()
+    : builder(1) {
+    // Building takes a few milliseconds, which adds up when a session loads a
+    // lot of instances, so it never happens on the thread creating the plugin
+    builder.addJob([this] { build(); });
+}
+
+void DSPTables::build() {
+    IGNITION_TRACE_ZONE("build tables");
+
+    for (int factor = 2; factor <= Oversampler::maxFactor; factor *= 2)
+        oversamplingFilters[factorIndex(factor)] = createOversamplingFilter(factor, Oversampler::tapsPerPhase);
+
+    blepResidual = createBlepResidual();
+
+    shaperTanh = createShaperTable([](double u) { return std::tanh(u); });
+    shaperFuzz = createShaperTable([](double u) { return 1.0 - std::exp(-u); });
+    shaperTables = { shaperTanh.data(), shaperFuzz.data() };
+
+    ready.store(true, std::memory_order_release);
+}
+
+bool DSPTables::isReady() const noexcept {
+    return ready.load(std::memory_order_acquire);
+}
+
+const DSPTables::OversamplingFilter* DSPTables::getOversamplingFilter(int factor) const noexcept {
+    jassert(factor == 2 || factor == 4 || factor == 8);
+
+    return isReady() ? &oversamplingFilters[factorIndex(factor)] : nullptr;
+}
+
+const std::vector<float>* DSPTables::getBlepResidual() const noexcept {
+    return isReady() ? &blepResidual : nullptr;
+}
+
+const DSPKernels::ShaperTables* DSPTables::getShaperTables() const noexcept {
+    return isReady() ? &shaperTables : nullptr;
+}
+
+size_t DSPTables::getSizeInBytes() const noexcept {
+    if (!isReady())
+        return sizeof(DSPTables);
+
+    size_t numFloats = blepResidual.capacity() + shaperTanh.capacity() + shaperFuzz.capacity();
+
+    for (const auto& filter : oversamplingFilters)
+        numFloats += filter.upPhases.capacity() + filter.downTaps.capacity();
+
+    return sizeof(DSPTables) + numFloats * sizeof(float);
+}
+
+DSPTables::OversamplingFilter DSPTables::createOversamplingFilter(int factor, int tapsPerPhase) {
+    // Kaiser windowed sinc with its cutoff at the base rate's Nyquist
+    const int length = factor * tapsPerPhase + 1;
+    const double centre = 0.5 * (double) (length - 1);
+    const double cutoff = 0.5 / (double) factor;
+    const double beta = 8.0;
+
+    auto besselI0 = [](double x) {
+        double sum = 1.0, term = 1.0;
+
+        for (int k = 1; k < 32; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+
+        return sum;
+    };
+
+    OversamplingFilter filter;
+    filter.factor = factor;
+    filter.tapsPerPhase = tapsPerPhase;
+    filter.downTaps.resize((size_t) length);
+
+    double total = 0.0;
+
+    for (int i = 0; i < length; ++i) {
+        const double t = (double) i - centre;
+        const double x = 2.0 * cutoff * t;
+        const double sinc = t == 0.0 ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+        const double r = t / centre;
+        const double window = besselI0(beta * std::sqrt(juce::jmax(0.0, 1.0 - r * r))) / besselI0(beta);
+
+        filter.downTaps[(size_t) i] = (float) (sinc * window);
+        total += sinc * window;
+    }
+
+    for (auto& tap : filter.downTaps)
+        tap = (float) (tap / total);
+
+    // Zero stuffing loses a factor of f in gain, so it goes back in the up phases
+    const int upLength = tapsPerPhase + 1;
+    filter.upPhases.assign((size_t) (factor * upLength), 0.0f);
+
+    for (int p = 0; p < factor; ++p) {
+        for (int i = 0; i < upLength; ++i) {
+            const int tap = p + (tapsPerPhase - i) * factor;
+
+            if (tap < length)
+                filter.upPhases[(size_t) (p * upLength + i)] = filter.downTaps[(size_t) tap] * (float) factor;
+        }
+    }
+
+    return filter;
+}
+
+std::vector<float> DSPTables::createBlepResidual() {
+    const int blepZeroCrossings = Decimator::blepZeroCrossings;
+    const int blepOversampling = Decimator::blepOversampling;
+    const int blepLength = Decimator::blepLength;
+
+    // Blackman windowed sinc
+    const int impulseLength = 2 * blepZeroCrossings * blepOversampling + 1;
+    const int fftOrder = 12;
+    const int fftSize = 1 << fftOrder;
+    jassert(impulseLength <= fftSize);
+
+    std::vector<juce::dsp::Complex<float>> a((size_t) fftSize), b((size_t) fftSize);
+
+    for (int i = 0; i < impulseLength; ++i) {
+        const double t = (double) (i - impulseLength / 2) / (double) blepOversampling;
+        const double sinc = t == 0.0 ? 1.0 : std::sin(juce::MathConstants<double>::pi * t) / (juce::MathConstants<double>::pi * t);
+        const double w = (double) i / (double) (impulseLength - 1);
+        const double window = 0.42 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * w)
+                            + 0.08 * std::cos(2.0 * juce::MathConstants<double>::twoPi * w);
+        a[(size_t) i] = (float) (sinc * window);
+    }
+
+    // Minimum phase version through the real cepstrum
+    juce::dsp::FFT fft(fftOrder);
+
+    fft.perform(a.data(), b.data(), false);
+
+    for (auto& x : b)
+        x = std::log(juce::jmax(std::abs(x), 1.0e-9f));
+
+    fft.perform(b.data(), a.data(), true);
+
+    for (int i = 1; i < fftSize / 2; ++i)
+        a[(size_t) i] *= 2.0f;
+
+    for (int i = fftSize / 2 + 1; i < fftSize; ++i)
+        a[(size_t) i] = 0.0f;
+
+    fft.perform(a.data(), b.data(), false);
+
+    for (auto& x : b)
+        x = std::exp(x);
+
+    fft.perform(b.data(), a.data(), true);
+
+    // Integrate into a step, then take away the ideal step
+    double total = 0.0;
+
+    for (const auto& x : a)
+        total += x.real();
+
+    std::vector<float> table((size_t) (blepLength * blepOversampling + 2));
+    double sum = 0.0;
+
+    for (size_t i = 0; i < table.size(); ++i) {
+        sum += a[i].real();
+        table[i] = (float) (sum / total - 1.0);
+    }
+
+    // Whatever ripple is left at the end would become a click when the
+    // correction stops, so fade it out over the last zero crossing
+    for (int i = 0; i < blepOversampling; ++i)
+        table[table.size() - 1 - (size_t) i] *= (float) i / (float) blepOversampling;
+
+    return table;
+}
+
+std::vector<float> DSPTables::createShaperTable(double (*curve)(double)) {
+    std::vector<float> table((size_t) DSPKernels::shaperTableSize + 1);
+
+    for (size_t i = 0; i < table.size(); ++i)
+        table[i] = (float) curve((double) i * DSPKernels::shaperTableRange / DSPKernels::shaperTableSize);
+
+    return table;
+}
@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    DSPTables.h
+    Created: 19 Oct 2026 6:20:48pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <JuceHeader.h>
+#include "DSPKernels.h"
+
+// Read-only tables shared by every instance in the process.
+//
+// Hold one through juce::SharedResourcePointer<DSPTables>: the first instance
+// starts building everything on a background thread, the rest just take a
+// reference, and the tables are freed with the last instance. Until the build
+// is done the getters return nullptr and callers fall back to their plain
+// versions. Nothing changes after that, so the audio threads of every
+// instance can read the tables without locking.
+class DSPTables {
+public:
+	// Polyphase filter for one oversampling factor
+	struct OversamplingFilter {
+		int factor = 0;
+		int tapsPerPhase = 0;
+		std::vector<float> upPhases; // factor rows of tapsPerPhase + 1, oldest tap first, gain included
+		std::vector<float> downTaps; // factor * tapsPerPhase + 1, symmetric
+	};
+
+	DSPTables();
+
+	bool isReady() const noexcept;
+
+	// factor is 2, 4 or 8, nullptr until the tables are ready
+	const OversamplingFilter* getOversamplingFilter(int factor) const noexcept;
+
+	// MinBLEP minus the ideal step, sampled Decimator::blepOversampling times per sample,
+	// nullptr until the tables are ready
+	const std::vector<float>* getBlepResidual() const noexcept;
+
+	// Tube and Fuzz curves for DSPKernels' table shaping, nullptr until the tables are ready
+	const DSPKernels::ShaperTables* getShaperTables() const noexcept;
+
+	// Everything held by the cache, for monitoring
+	size_t getSizeInBytes() const noexcept;
+
+private:
+	void build();
+
+	static OversamplingFilter createOversamplingFilter(int factor, int tapsPerPhase);
+	static std::vector<float> createBlepResidual();
+	static std::vector<float> createShaperTable(double (*curve)(double));
+
+	OversamplingFilter oversamplingFilters[3]; // indexed by log2(factor) - 1
+	std::vector<float> blepResidual;
+
+	std::vector<float> shaperTanh, shaperFuzz;
+	DSPKernels::ShaperTables shaperTables{ nullptr, nullptr };
+
+	std::atomic<bool> ready { false };
+
+	// Last, so it finishes the build before the tables go away
+	juce::ThreadPool builder;
+
+	JUCE_DECLARE_NON_COPYABLE(DSPTables)
+};
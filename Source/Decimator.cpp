@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    Decimator.cpp
+    Created: 19 Oct 2026 3:06:21pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#include "Decimator.h"
+
+static_assert(Decimator::blepLength <= 64, "The MinBLEP ring in ChannelState is too short");
+
+Decimator::Decimator()
+    : kernels(&DSPKernels::getKernels(DSPKernels::InstructionSet::scalar)), factor(1.0f), increment(1.0f), inverseIncrement(1.0f), bandLimited(false) {
+
+}
+
+void Decimator::prepare(int numChannels) {
+    state.resize(numChannels);
+    reset();
+}
+
+void Decimator::reset() {
+    for (auto& s : state)
+        s = {};
+}
+
+void Decimator::setKernels(const DSPKernels::KernelTable& newKernels) {
+    kernels = &newKernels;
+}
+
+void Decimator::setFactor(float newFactor) {
+    factor = juce::jmax(1.0f, newFactor);
+    increment = 1.0f / factor;
+    inverseIncrement = factor;
+}
+
+void Decimator::setBandLimited(bool shouldBeBandLimited) {
+    bandLimited = shouldBeBandLimited;
+}
+
+void Decimator::process(int channel, float* data, int numSamples, float numSteps, float stepSize) {
+    if (factor <= 1.0f && !bandLimited) {
+        // Nothing is held, this is just the bit crusher
+        kernels->quantize(data, numSteps, stepSize, numSamples);
+        return;
+    }
+
+    jassert(juce::isPositiveAndBelow(channel, (int) state.size()));
+
+    holdAndQuantize(state[(size_t) channel], data, numSamples, 1, numSteps, stepSize);
+}
+
+void Decimator::processStrided(int channel, float* data, int stride, int numSamples, float numSteps, float stepSize) {
+    jassert(juce::isPositiveAndBelow(channel, (int) state.size()));
+
+    holdAndQuantize(state[(size_t) channel], data, numSamples, stride, numSteps, stepSize);
+}
+
+void Decimator::processMidSide(float* frames, int numFrames, const float* numSteps, const float* stepSize) {
+    jassert(state.size() >= 2);
+
+    // Each lane runs its own hold, the quantizers differ so there's no shortcut at 1x
+    for (int lane = 0; lane < 2; ++lane)
+        holdAndQuantize(state[(size_t) lane], frames + lane, numFrames, 2, numSteps[lane], stepSize[lane]);
+}
+
+void Decimator::holdAndQuantize(ChannelState& s, float* data, int numSamples, int stride, float numSteps, float stepSize) {
+    const auto* residual = bandLimited ? tables->getBlepResidual() : nullptr;
+    int i = 0;
+
+    while (i < numSamples) {
+        if (s.phase >= 1.0f) {
+            s.phase -= 1.0f;
+
+            const float sample = std::round(data[i * stride] * numSteps) * stepSize;
+
+            // The step really happened s.phase / increment samples ago. Until the
+            // shared table is ready the steps just stay as they are.
+            if (bandLimited && sample != s.held && residual != nullptr)
+                addBlep(s, *residual, s.phase * inverseIncrement, sample - s.held);
+
+            s.held = sample;
+        }
+
+        // Hold until the next capture, or the end of the block
+        const int run = juce::jlimit(1, numSamples - i, (int) std::ceil((1.0f - s.phase) * inverseIncrement));
+
+        if (stride == 1) {
+            juce::FloatVectorOperations::fill(data + i, s.held, run);
+        }
+        else {
+            for (int j = i; j < i + run; ++j)
+                data[j * stride] = s.held;
+        }
+
+        if (bandLimited) {
+            for (int j = i; j < i + run; ++j) {
+                data[j * stride] += s.blep[s.blepPosition];
+                s.blep[s.blepPosition] = 0.0f;
+                s.blepPosition = (s.blepPosition + 1) & blepRingMask;
+            }
+        }
+
+        s.phase += (float) run * increment;
+        i += run;
+    }
+}
+
+void Decimator::addBlep(ChannelState& s, const std::vector<float>& residual, float offset, float height) const {
+    for (int k = 0; k < blepLength; ++k) {
+        const float position = ((float) k + offset) * (float) blepOversampling;
+        const int index = (int) position;
+        const float fraction = position - (float) index;
+        const float value = residual[index] + fraction * (residual[index + 1] - residual[index]);
+
+        s.blep[(s.blepPosition + k) & blepRingMask] += height * value;
+    }
+}
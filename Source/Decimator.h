@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    Decimator.h
+    Created: 19 Oct 2026 3:06:21pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <JuceHeader.h>
+#include "DSPKernels.h"
+#include "DSPTables.h"
+
+// Sample rate reduction for the Downsample algorithm.
+//
+// A fractional sample and hold runs at sampleRate / factor and each held
+// sample goes through a bit depth quantizer. The held runs are written with
+// plain fills, so the hold itself costs a store per output sample. With band
+// limiting on, every step in the output is replaced by a minimum phase
+// band limited step (MinBLEP) to take the edge off the aliasing.
+class Decimator {
+public:
+	static constexpr int blepZeroCrossings = 16;
+	static constexpr int blepOversampling = 32;
+	static constexpr int blepLength = blepZeroCrossings * 2; // in samples at the output rate
+
+	Decimator();
+
+	void prepare(int numChannels);
+	void reset();
+
+	void setKernels(const DSPKernels::KernelTable& newKernels);
+
+	// How many output samples each held sample lasts, 1 or more, can be fractional
+	void setFactor(float newFactor);
+	void setBandLimited(bool shouldBeBandLimited);
+
+	// numSteps quantizer levels per unit, stepSize is 1 / numSteps
+	void process(int channel, float* data, int numSamples, float numSteps, float stepSize);
+
+	// Same as process over every stride-th sample, for one lane of interleaved frames
+	void processStrided(int channel, float* data, int stride, int numSamples, float numSteps, float stepSize);
+
+	// Interleaved mid/side frames with a quantizer per lane, using the state of channels 0 and 1
+	void processMidSide(float* frames, int numFrames, const float* numSteps, const float* stepSize);
+
+private:
+	struct ChannelState {
+		float phase = 1.0f; // captures a new sample once this reaches 1
+		float held = 0.0f;
+		int blepPosition = 0;
+		float blep[64] = {}; // pending MinBLEP corrections, a ring indexed from blepPosition
+	};
+
+	static constexpr int blepRingMask = 63;
+
+	void holdAndQuantize(ChannelState& state, float* data, int numSamples, int stride, float numSteps, float stepSize);
+	void addBlep(ChannelState& state, const std::vector<float>& residual, float offset, float height) const;
+
+	const DSPKernels::KernelTable* kernels;
+
+	// The MinBLEP table is shared with every other instance
+	juce::SharedResourcePointer<DSPTables> tables;
+
+	std::vector<ChannelState> state;
+
+	float factor;
+	float increment;
+	float inverseIncrement;
+	bool bandLimited;
+};
@@ -0,0 +1,532 @@
+/*
+  ==============================================================================
+
+    Diagnostics.cpp
+    Created: 19 Oct 2026 7:02:15pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#include "Diagnostics.h"
+
+#if IGNITION_DIAGNOSTICS
+
+#include <cstdlib>
+#include <new>
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+#include "CaptureRecorder.h"
+
+// Counts every plain new on the thread making it. This replaces the global
+// operator new for the whole plugin, which is only acceptable because it never
+// leaves a diagnostics build.
+static thread_local juce::int64 numAllocations = 0;
+
+void* operator new(std::size_t size) {
+    ++numAllocations;
+
+    if (void* p = std::malloc(size > 0 ? size : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+juce::int64 Diagnostics::getNumAllocations() noexcept {
+    return numAllocations;
+}
+
+static double millisecondsSince(juce::int64 startTicks) {
+    return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+}
+
+static juce::String formatTiming(const juce::String& name, double milliseconds, int numInstances) {
+    return "  " + name + ": " + juce::String(milliseconds, 2) + " ms total, "
+         + juce::String(milliseconds / numInstances, 3) + " ms per instance\n";
+}
+
+void Diagnostics::runRequestedBenchmarks() {
+    // Plugins are created on the message thread, so a plain flag is enough
+    static bool hasRun = false;
+
+    if (hasRun)
+        return;
+
+    hasRun = true;
+
+    // Inside a host, so failures only go to the log. The console runner is
+    // the one that turns them into an exit code.
+    runBenchmarks(juce::StringArray::fromTokens(juce::SystemStats::getEnvironmentVariable("IGNITION_BENCHMARK", {}), ",", {}));
+}
+
+int Diagnostics::runBenchmarks(const juce::StringArray& names, const juce::File& aliasingCsv) {
+    int exitCode = 0;
+
+    auto fail = [&](const juce::String& name) {
+        juce::Logger::writeToLog("Ignition: " + name + " FAILED");
+        exitCode = 1;
+    };
+
+    for (const auto& entry : names) {
+        const auto name = entry.trim();
+
+        if (name == "instantiation")
+            juce::Logger::writeToLog(runInstantiationBenchmark());
+        else if (name == "editor-paint")
+            juce::Logger::writeToLog(runEditorPaintBenchmark());
+        else if (name == "filter")
+            juce::Logger::writeToLog(runFilterBenchmark());
+        else if (name == "accuracy") {
+            bool passed = false;
+            juce::Logger::writeToLog(runAccuracySuite(passed));
+
+            // A fast path has drifted, the report says which
+            if (!passed)
+                fail(name);
+        }
+        else if (name == "replay") {
+            const auto path = juce::SystemStats::getEnvironmentVariable("IGNITION_REPLAY", {});
+            const int numPasses = juce::jmax(1, juce::SystemStats::getEnvironmentVariable("IGNITION_REPLAY_PASSES", "1").getIntValue());
+
+            bool bitExact = false;
+            juce::Logger::writeToLog(runReplay(juce::File::getCurrentWorkingDirectory().getChildFile(path), numPasses, bitExact));
+
+            // Something the capture doesn't cover has changed the output, the report says where
+            if (!bitExact)
+                fail(name);
+        }
+        else if (name == "aliasing") {
+            const auto path = juce::SystemStats::getEnvironmentVariable("IGNITION_ALIASING_CSV", "Ignition aliasing.csv");
+            juce::Logger::writeToLog(runAliasingSuite(aliasingCsv != juce::File() ? aliasingCsv
+                                                                                  : juce::File::getCurrentWorkingDirectory().getChildFile(path)));
+        }
+        else if (name.isNotEmpty())
+            fail("unknown benchmark " + name);
+    }
+
+    return exitCode;
+}
+
+juce::String Diagnostics::runInstantiationBenchmark() {
+    const double sampleRate = 48000.0;
+    const int blockSize = 512;
+
+    juce::String report = "Ignition instantiation benchmark, 48 kHz, 512 sample blocks\n";
+    juce::Random random(1);
+
+    for (int numInstances : { 1, 16, 256 }) {
+        std::vector<std::unique_ptr<IngitionAudioProcessor>> instances;
+        instances.reserve((size_t) numInstances);
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < blockSize; ++i)
+                buffer.setSample(channel, i, random.nextFloat() * 2.0f - 1.0f);
+
+        const auto constructStart = juce::Time::getHighResolutionTicks();
+
+        for (int i = 0; i < numInstances; ++i)
+            instances.push_back(std::make_unique<IngitionAudioProcessor>());
+
+        const double constructTime = millisecondsSince(constructStart);
+        const auto prepareStart = juce::Time::getHighResolutionTicks();
+
+        for (auto& instance : instances) {
+            instance->setRateAndBufferSizeDetails(sampleRate, blockSize);
+            instance->prepareToPlay(sampleRate, blockSize);
+        }
+
+        const double prepareTime = millisecondsSince(prepareStart);
+        const auto processStart = juce::Time::getHighResolutionTicks();
+
+        for (auto& instance : instances)
+            instance->processBlock(buffer, midi);
+
+        const double processTime = millisecondsSince(processStart);
+
+        report += juce::String(numInstances) + (numInstances == 1 ? " instance\n" : " instances\n");
+        report += formatTiming("construct", constructTime, numInstances);
+        report += formatTiming("prepareToPlay", prepareTime, numInstances);
+        report += formatTiming("first processBlock", processTime, numInstances);
+        report += formatTiming("all", constructTime + prepareTime + processTime, numInstances);
+
+        // Every instance goes before the next round, so the shared tables start cold again
+        instances.clear();
+    }
+
+    return report;
+}
+
+juce::String Diagnostics::runEditorPaintBenchmark() {
+    const double sampleRate = 48000.0;
+    const int blockSize = 512;
+    const int numFrames = 600;
+    const int numResizes = 1000;
+
+    IngitionAudioProcessor processor;
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midi;
+    juce::Random random(1);
+
+    // A decaying noise burst every half second, so the envelopes have something to draw
+    int burstPosition = 0;
+
+    auto processSyntheticBlock = [&] {
+        for (int i = 0; i < blockSize; ++i) {
+            const float level = std::exp(-8.0f * (float) burstPosition / (float) sampleRate);
+            burstPosition = (burstPosition + 1) % (int) (sampleRate / 2);
+
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                buffer.setSample(channel, i, level * (random.nextFloat() * 2.0f - 1.0f));
+        }
+
+        processor.processBlock(buffer, midi);
+    };
+
+    // Warm up the envelope histories before the editor exists
+    for (int i = 0; i < 100; ++i)
+        processSyntheticBlock();
+
+    IngitionAudioProcessorEditor editor(processor);
+
+    juce::Image frame(juce::Image::ARGB, editor.getWidth(), editor.getHeight(), true);
+
+    // What paint() draws from, to tell whether a frame had anything new
+    auto hashPaintedData = [&] {
+        juce::int64 hash = 17;
+
+        auto add = [&](const std::vector<float>& values) {
+            for (float value : values)
+                hash = hash * 31 + (juce::int64) std::llround(value * 1.0e6f);
+        };
+
+        std::vector<EnvelopeHistory::Range> envelope(300);
+        processor.getEnvelopeHistory().read(2.0, envelope.data(), (int) envelope.size());
+
+        for (const auto& range : envelope)
+            add({ range.min, range.max });
+
+        add(processor.getWaveshape());
+
+        for (const auto* meter : { &processor.getInputMeter(), &processor.getOutputMeter() }) {
+            const auto reading = meter->getReading();
+            add({ reading.peak, reading.truePeak, reading.rms });
+        }
+
+        return hash;
+    };
+
+    double totalPaintTime = 0.0, maxPaintTime = 0.0;
+    juce::int64 totalAllocations = 0, maxAllocations = 0;
+    int totalRepaints = 0, redundantRepaints = 0, unchangedFrames = 0;
+    juce::int64 lastHash = hashPaintedData();
+
+    for (int i = 0; i < numFrames; ++i) {
+        // Audio arrives at half the frame rate, so every other frame has nothing new
+        if (i % 2 == 0)
+            processSyntheticBlock();
+
+        const juce::int64 hash = hashPaintedData();
+        const bool changed = hash != lastHash;
+        lastHash = hash;
+
+        const int repaintsBefore = editor.getNumRepaintRequests();
+        const juce::int64 allocationsBefore = getNumAllocations();
+        const auto paintStart = juce::Time::getHighResolutionTicks();
+
+        {
+            juce::Graphics g(frame);
+            editor.paintEntireComponent(g, true);
+        }
+
+        const double paintTime = millisecondsSince(paintStart);
+        const juce::int64 allocations = getNumAllocations() - allocationsBefore;
+        const int repaints = editor.getNumRepaintRequests() - repaintsBefore;
+
+        totalPaintTime += paintTime;
+        maxPaintTime = juce::jmax(maxPaintTime, paintTime);
+        totalAllocations += allocations;
+        maxAllocations = juce::jmax(maxAllocations, allocations);
+        totalRepaints += repaints;
+
+        if (!changed) {
+            ++unchangedFrames;
+            redundantRepaints += repaints;
+        }
+    }
+
+    const auto resizeStart = juce::Time::getHighResolutionTicks();
+
+    for (int i = 0; i < numResizes; ++i)
+        editor.resized();
+
+    const double resizeTime = millisecondsSince(resizeStart);
+
+    juce::String report = "Ignition editor paint benchmark, " + juce::String(editor.getWidth()) + "x" + juce::String(editor.getHeight())
+                        + ", " + juce::String(numFrames) + " frames\n";
+    report += "  paint: " + juce::String(totalPaintTime / numFrames, 3) + " ms per frame, " + juce::String(maxPaintTime, 3) + " ms worst\n";
+    report += "  allocations: " + juce::String((double) totalAllocations / numFrames, 1) + " per frame, "
+            + juce::String((int) maxAllocations) + " worst\n";
+    report += "  repaints asked for: " + juce::String(totalRepaints) + ", " + juce::String(redundantRepaints)
+            + " of them in the " + juce::String(unchangedFrames) + " frames with nothing new\n";
+    report += "  resized: " + juce::String(resizeTime * 1000.0 / numResizes, 2) + " us per call\n";
+
+    return report;
+}
+
+juce::String Diagnostics::runFilterBenchmark() {
+    const double sampleRate = 48000.0;
+    const int blockSize = 128;
+    const int numBlocks = (int) sampleRate * 10 / blockSize;
+
+    juce::String report = "Ignition filter benchmark, 48 kHz, 128 sample blocks, 10 s per run, full resonance\n";
+
+    const auto& kernels = DSPKernels::getKernels(DSPKernels::selectInstructionSet());
+    std::vector<float> input((size_t) blockSize), data((size_t) blockSize), cutoff((size_t) blockSize), g((size_t) blockSize), h((size_t) blockSize);
+
+    // -1 is the linear filter, the rest are the saturating one at each tier's cap
+    for (int tier = -1; tier < QualitySettings::numTiers; ++tier) {
+        const int maxIterations = tier < 0 ? 0 : QualitySettings::forTier(tier).filterIterations;
+
+        report += tier < 0 ? juce::String("linear\n")
+                           : "saturating, at most " + juce::String(maxIterations) + " steps per sample\n";
+
+        for (float level : { 0.25f, 1.0f, 4.0f }) {
+            StateVariableFilter filter;
+            filter.setKernels(kernels);
+            filter.prepare({ sampleRate, (juce::uint32) blockSize, 1 });
+            filter.setResonance(4.0f);
+            filter.setSaturating(tier >= 0);
+            filter.setMaxIterations(maxIterations);
+
+            juce::Random random(1);
+            double totalTime = 0.0, worstTime = 0.0;
+
+            for (int block = 0; block < numBlocks; ++block) {
+                for (int i = 0; i < blockSize; ++i) {
+                    const double t = (double) (block * blockSize + i) / sampleRate;
+
+                    // A saw with some noise, under a cutoff sweeping 100 Hz to 15 kHz twice a second
+                    input[(size_t) i] = level * ((float) (2.0 * std::fmod(t * 110.0, 1.0) - 1.0) + 0.1f * (random.nextFloat() * 2.0f - 1.0f));
+                    cutoff[(size_t) i] = (float) (100.0 * std::pow(150.0, 0.5 + 0.5 * std::sin(t * juce::MathConstants<double>::twoPi * 2.0)));
+                }
+
+                filter.computeCoefficients(cutoff.data(), g.data(), h.data(), blockSize);
+                juce::FloatVectorOperations::copy(data.data(), input.data(), blockSize);
+
+                const auto start = juce::Time::getHighResolutionTicks();
+                filter.process(0, data.data(), g.data(), h.data(), blockSize);
+                const double time = millisecondsSince(start);
+
+                totalTime += time;
+                worstTime = juce::jmax(worstTime, time);
+            }
+
+            const double nanosecondsPerMillisecond = 1.0e6;
+
+            report += "  level " + juce::String(level, 2) + ": " + juce::String(totalTime * nanosecondsPerMillisecond / (numBlocks * blockSize), 1)
+                    + " ns per sample, " + juce::String(worstTime * nanosecondsPerMillisecond / blockSize, 1) + " in the worst block";
+
+            if (tier >= 0) {
+                const auto stats = filter.getSolverStats();
+
+                report += ", " + juce::String((double) stats.numIterations / (double) stats.numSamples, 2) + " steps per sample, "
+                        + juce::String(stats.mostIterations) + " most";
+            }
+
+            report += "\n";
+        }
+    }
+
+    return report;
+}
+
+namespace {
+    // Plays back what the host's playhead said when the block was captured
+    class ReplayPlayHead : public juce::AudioPlayHead {
+    public:
+        juce::Optional<PositionInfo> getPosition() const override {
+            return info;
+        }
+
+        void set(const CaptureRecorder::BlockHeader& block) {
+            info = PositionInfo();
+
+            if ((block.flags & CaptureRecorder::hasBpm) != 0)
+                info.setBpm(block.bpm);
+
+            if ((block.flags & CaptureRecorder::hasPpq) != 0)
+                info.setPpqPosition(block.ppq);
+
+            info.setIsPlaying((block.flags & CaptureRecorder::isPlaying) != 0);
+        }
+
+    private:
+        PositionInfo info;
+    };
+
+    struct ReplayedBlock {
+        int index = 0;
+        double sessionTime = 0.0; // seconds since the first block was captured
+        int numSamples = 0;
+        double milliseconds = 0.0;
+    };
+}
+
+juce::String Diagnostics::runReplay(const juce::File& captureFile, int numPasses, bool& bitExact) {
+    bitExact = false;
+
+    juce::String report = "Ignition replay of " + captureFile.getFullPathName() + "\n";
+
+    CaptureRecorder::FileHeader fileHeader;
+
+    {
+        juce::FileInputStream input(captureFile);
+
+        if (!input.openedOk() || !CaptureRecorder::readFileHeader(input, fileHeader))
+            return report + "  not a capture this version can read\n";
+    }
+
+    if (fileHeader.numParameters != IngitionAudioProcessor::getNumSnapshotParameters())
+        return report + "  captured with " + juce::String(fileHeader.numParameters) + " parameters, this build has "
+             + juce::String(IngitionAudioProcessor::getNumSnapshotParameters()) + "\n";
+
+    report += "  " + juce::String(fileHeader.sampleRate) + " Hz, " + juce::String(fileHeader.maxBlockSize) + " sample blocks, "
+            + juce::String(fileHeader.numChannels) + " channels, " + juce::String(numPasses) + (numPasses == 1 ? " pass\n" : " passes\n");
+
+    std::vector<float> parameters((size_t) fileHeader.numParameters);
+    juce::AudioBuffer<float> buffer(fileHeader.numChannels, fileHeader.maxBlockSize);
+    juce::MidiBuffer midi;
+
+    // The captured blocks that had the real tables only replay with them too
+    juce::SharedResourcePointer<DSPTables> tables;
+
+    while (!tables->isReady())
+        juce::Thread::sleep(1);
+
+    std::vector<ReplayedBlock> blocks;
+    int numMismatches = 0, firstMismatch = -1, numGaps = 0, numColdBlocks = 0, numColdMismatches = 0;
+
+    for (int pass = 0; pass < numPasses; ++pass) {
+        juce::FileInputStream input(captureFile);
+        CaptureRecorder::readFileHeader(input, fileHeader);
+
+        CaptureRecorder::BlockHeader block;
+        juce::uint64 capturedHash = 0;
+
+        if (!CaptureRecorder::readBlock(input, fileHeader, block, parameters.data(), buffer, capturedHash))
+            return report + "  no blocks in the capture\n";
+
+        // Same state the captured instance was in at prepareToPlay, as far as the capture knows it
+        ReplayPlayHead playHead;
+        IngitionAudioProcessor processor;
+        processor.setPlayHead(&playHead);
+        processor.setNonRealtime((block.flags & CaptureRecorder::nonRealtime) != 0);
+        processor.setParameterSnapshot(parameters.data());
+        processor.setRateAndBufferSizeDetails(fileHeader.sampleRate, fileHeader.maxBlockSize);
+        processor.prepareToPlay(fileHeader.sampleRate, fileHeader.maxBlockSize);
+
+        const juce::int64 firstTicks = block.ticks;
+
+        for (int index = 0;; ++index) {
+            // Gaps break the chain of state, everything after one is only approximate
+            if (block.numDropped > 0 && pass == 0)
+                ++numGaps;
+
+            // These ran the stand ins for the tables, which the replay no longer has
+            const bool cold = (block.flags & CaptureRecorder::tablesReady) == 0;
+
+            if (cold && pass == 0)
+                ++numColdBlocks;
+
+            playHead.set(block);
+            processor.setNonRealtime((block.flags & CaptureRecorder::nonRealtime) != 0);
+            processor.setParameterSnapshot(parameters.data());
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(buffer, midi);
+            const double milliseconds = millisecondsSince(start);
+
+            if (pass == 0) {
+                if (CaptureRecorder::hashChannels(buffer, block.numChannels, block.numSamples) != capturedHash) {
+                    if (cold) {
+                        ++numColdMismatches;
+                    }
+                    else {
+                        ++numMismatches;
+
+                        if (firstMismatch < 0)
+                            firstMismatch = index;
+                    }
+                }
+
+                ReplayedBlock replayed;
+                replayed.index = index;
+                replayed.sessionTime = juce::Time::highResolutionTicksToSeconds(block.ticks - firstTicks);
+                replayed.numSamples = block.numSamples;
+                replayed.milliseconds = milliseconds;
+                blocks.push_back(replayed);
+            }
+            else {
+                blocks[(size_t) index].milliseconds = juce::jmax(blocks[(size_t) index].milliseconds, milliseconds);
+            }
+
+            if (!CaptureRecorder::readBlock(input, fileHeader, block, parameters.data(), buffer, capturedHash))
+                break;
+        }
+    }
+
+    double totalTime = 0.0;
+    juce::int64 totalSamples = 0;
+
+    for (const auto& block : blocks) {
+        totalTime += block.milliseconds;
+        totalSamples += block.numSamples;
+    }
+
+    const double audioMilliseconds = 1000.0 * (double) totalSamples / fileHeader.sampleRate;
+
+    report += "  " + juce::String((int) blocks.size()) + " blocks, " + juce::String(audioMilliseconds / 1000.0, 2) + " s of audio, "
+            + juce::String(numGaps) + " gaps from dropped blocks\n";
+
+    if (numColdBlocks > 0)
+        report += "  " + juce::String(numColdBlocks) + " blocks captured before the shared tables were ready, "
+                + juce::String(numColdMismatches) + " of them differ and aren't counted below\n";
+    report += "  processBlock: " + juce::String(totalTime, 2) + " ms, " + juce::String(100.0 * totalTime / juce::jmax(audioMilliseconds, 1.0e-9), 2)
+            + "% of realtime" + (numPasses > 1 ? ", slowest pass per block\n" : "\n");
+
+    auto slowest = blocks;
+    const size_t numSlowest = juce::jmin((size_t) 5, slowest.size());
+
+    std::partial_sort(slowest.begin(), slowest.begin() + (std::ptrdiff_t) numSlowest, slowest.end(),
+                      [](const ReplayedBlock& a, const ReplayedBlock& b) { return a.milliseconds > b.milliseconds; });
+
+    for (size_t i = 0; i < numSlowest; ++i)
+        report += "    block " + juce::String(slowest[i].index) + " at " + juce::String(slowest[i].sessionTime, 3) + " s, "
+                + juce::String(slowest[i].numSamples) + " samples: " + juce::String(slowest[i].milliseconds, 3) + " ms\n";
+
+    if (numMismatches == 0) {
+        report += "  output bit exact\n";
+        bitExact = true;
+    }
+    else {
+        report += "  output differs in " + juce::String(numMismatches) + " blocks, first at block " + juce::String(firstMismatch) + "\n";
+    }
+
+    return report;
+}
+
+#endif
@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    Diagnostics.h
+    Created: 19 Oct 2026 7:02:15pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Developer benchmarks, compiled in only when IGNITION_DIAGNOSTICS is 1.
+//
+// Diagnostics/IgnitionDiagnostics.jucer builds them into a console runner
+// that takes the benchmark names as arguments and exits with 1 if any of
+// them failed. A plugin built with the flag runs the ones IGNITION_BENCHMARK
+// lists instead, once, before the host's first instance is created, for
+// profiling inside a host. Either way the reports go to the JUCE log.
+#ifndef IGNITION_DIAGNOSTICS
+ #define IGNITION_DIAGNOSTICS 0
+#endif
+
+#if IGNITION_DIAGNOSTICS
+
+namespace Diagnostics {
+	// Runs whatever IGNITION_BENCHMARK asks for, only the first call does anything
+	void runRequestedBenchmarks();
+
+	// The benchmarks by name, for the console runner's main(). Logs a FAILED line
+	// for each one that fails or isn't known, and returns 1 if there were any.
+	// aliasingCsv, if given, is used instead of IGNITION_ALIASING_CSV.
+	int runBenchmarks(const juce::StringArray& names, const juce::File& aliasingCsv = {});
+
+	// "instantiation": construct, prepareToPlay and the first processBlock for
+	// 1, 16 and 256 instances, each round starting with nothing shared
+	juce::String runInstantiationBenchmark();
+
+	// "editor-paint": paints the editor into an offscreen image, no display needed,
+	// while the processor runs on synthetic audio, timing paint() and resized(),
+	// counting allocations per frame and repaints asked for with nothing new to show
+	juce::String runEditorPaintBenchmark();
+
+	// "filter": the linear filter against the saturating one at each tier's
+	// iteration cap, over a swept cutoff at a few input levels. Reports the mean
+	// and worst time per sample, and the Newton steps per sample.
+	juce::String runFilterBenchmark();
+
+	// "accuracy": renders sweeps, noise and transients through every kernel on
+	// every instruction set the CPU has, the filter at both coefficient rates and
+	// saturating, the engine's antiderivative and polynomial shaping under a drive
+	// swinging below zero, and the processor, comparing each against a double precision reference
+	// with per path tolerances. passed is false if any path drifts out of them.
+	juce::String runAccuracySuite(bool& passed);
+
+	// "replay": feeds the capture named by IGNITION_REPLAY (see CaptureRecorder)
+	// back through processBlock, IGNITION_REPLAY_PASSES times with a fresh
+	// instance each, for running under a profiler. Reports the slowest blocks
+	// with their time in the original session, and any block whose output
+	// isn't bit for bit what was captured. bitExact is false if there were any.
+	juce::String runReplay(const juce::File& captureFile, int numPasses, bool& bitExact);
+
+	// "aliasing": runs every algorithm through every shaping and oversampling
+	// mode over a drive sweep, with a stepped sine sweep and multi-tone signals
+	// on exact FFT bins. Measures THD (or THD plus intermodulation), aliased
+	// energy overall and below the lowest tone, and CPU per second of audio,
+	// writing every measurement to csvFile. The console runner's --csv or
+	// IGNITION_ALIASING_CSV names the file.
+	juce::String runAliasingSuite(const juce::File& csvFile);
+
+	// Heap allocations made by the calling thread so far
+	juce::int64 getNumAllocations() noexcept;
+}
+
+#endif
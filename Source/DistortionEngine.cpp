@@ -10,8 +10,29 @@
 
 #include "DistortionEngine.h"
 
-DistortionEngine::DistortionEngine() : drive(1.0f), distortionAlgorithm(0) {
+DistortionEngine::DistortionEngine()
+    : kernels(&DSPKernels::getKernels(DSPKernels::InstructionSet::scalar)), distortionAlgorithm(0), drive(1.0f), modulation(0.0f), shaping(Shaping::approximate), polynomialDegree(0) {
+    updateQuantizer();
+    setPolynomialDegree(DSPKernels::maxChebyshevCoefficients - 1);
+    setSampleRate(44100.0);
+}
+
+void DistortionEngine::prepare(int numChannels) {
+    decimator.prepare(numChannels);
+
+    // Mid/side always has two lanes, and lane groups can run past the last channel
+    const int numLaneGroups = (numChannels + DSPKernels::maxLaneGroupSize - 1) / DSPKernels::maxLaneGroupSize;
+    const size_t numLanes = (size_t) juce::jmax(numLaneGroups * DSPKernels::maxLaneGroupSize, 2);
+
+    previousInputs.assign(numLanes, 0.0f);
+    diodeStates.assign(2 * numLanes, 0.0f);
+    polynomialFits.assign(numLanes, PolynomialFit());
+    polynomialPhases.assign(numLanes, 0);
+}
 
+void DistortionEngine::setKernels(const DSPKernels::KernelTable& newKernels) {
+    kernels = &newKernels;
+    decimator.setKernels(newKernels);
 }
 
 void DistortionEngine::setDistortionAlgorithm(int algorithm) {
@@ -20,14 +41,69 @@ void DistortionEngine::setDistortionAlgorithm(int algorithm) {
 
 void DistortionEngine::setDrive(float newDrive) {
     drive = newDrive;
+    updateQuantizer();
 }
 
 void DistortionEngine::setModulation(float newModulation) {
     modulation = newModulation;
+    updateQuantizer();
+}
+
+void DistortionEngine::setDownsampleFactor(float newFactor) {
+    decimator.setFactor(newFactor);
+}
+
+void DistortionEngine::setDownsampleBandLimited(bool shouldBeBandLimited) {
+    decimator.setBandLimited(shouldBeBandLimited);
+}
+
+void DistortionEngine::setShaping(Shaping newShaping) {
+    shaping = newShaping;
+}
+
+void DistortionEngine::setSampleRate(double sampleRate) {
+    diodeCircuit = getDiodeClipper(sampleRate);
+}
+
+DSPKernels::DiodeClipper DistortionEngine::getDiodeClipper(double sampleRate) {
+    // Bilinear capacitor, in parallel with the source where they meet the diodes
+    const double capacitorResistance = 1.0 / (2.0 * sampleRate * diodeCapacitance);
+    const double portResistance = diodeResistance * capacitorResistance / (diodeResistance + capacitorResistance);
+
+    auto offset = [](double rIs) { return std::log(rIs / diodeThermalVoltage) + rIs / diodeThermalVoltage; };
+
+    DSPKernels::DiodeClipper circuit;
+    circuit.sourceShare = (float) (portResistance / diodeResistance);
+    circuit.rootRIs = (float) (portResistance * diodeSaturationCurrent);
+    circuit.rootOffset = (float) offset(portResistance * diodeSaturationCurrent);
+    circuit.thermalVoltage = (float) diodeThermalVoltage;
+
+    return circuit;
+}
+
+int DistortionEngine::getAliasFreeDegree(int oversamplingFactor) {
+    // Harmonic N of a tone at the old Nyquist sits at N * fs / 2, and folds to
+    // factor * fs - N * fs / 2, which stays above fs / 2 while N <= 2 * factor - 1
+    return juce::jlimit(1, DSPKernels::maxChebyshevCoefficients - 1, 2 * oversamplingFactor - 1);
+}
+
+void DistortionEngine::setPolynomialDegree(int degree) {
+    degree = juce::jlimit(1, DSPKernels::maxChebyshevCoefficients - 1, degree);
+
+    if (degree == polynomialDegree)
+        return;
+
+    polynomialDegree = degree;
+
+    const int numNodes = degree + 1;
+
+    for (int k = 0; k < numNodes; ++k)
+        for (int j = 0; j < numNodes; ++j)
+            chebyshevBasis[(size_t) k][(size_t) j] = (float) std::cos(juce::MathConstants<double>::pi * k * (j + 0.5) / numNodes);
 }
 
 float DistortionEngine::getDrive() {
-    return drive + (modulation * 20.0f);
+    return juce::jlimit(minDrive, maxDrive, drive + (modulation * 20.0f));
 }
 
 std::vector<float> DistortionEngine::getWaveshape() {
@@ -46,6 +122,286 @@ float DistortionEngine::processSample(float sample) {
     return distort(sample);
 }
 
+void DistortionEngine::computeDrive(const float* modulationIn, float* driveOut, int numSamples) const {
+    // Same as getDrive(), once per sample
+    juce::FloatVectorOperations::copyWithMultiply(driveOut, modulationIn, 20.0f, numSamples);
+    juce::FloatVectorOperations::add(driveOut, drive, numSamples);
+    juce::FloatVectorOperations::clip(driveOut, driveOut, minDrive, maxDrive, numSamples);
+}
+
+void DistortionEngine::processBlock(int channel, float* data, const float* driveBuffer, int numSamples) {
+    if (distortionAlgorithm == 4) {
+        // The quantizer only changes once per block, from the drive at the end of it
+        float numSteps, stepSize;
+        computeQuantizer(driveBuffer[numSamples - 1], numSteps, stepSize);
+
+        decimator.process(channel, data, numSamples, numSteps, stepSize);
+        return;
+    }
+
+    if (distortionAlgorithm == 5) {
+        kernels->diodeClipper(diodeCircuit, &diodeStates[2 * (size_t) channel], data, driveBuffer, 1, numSamples);
+        return;
+    }
+
+    switch (shaping)
+    {
+    case Shaping::antiderivative:
+        processAntiderivative(data, driveBuffer, 1, previousInputs[(size_t) channel], numSamples);
+        break;
+    case Shaping::polynomial:
+        processPolynomial(data, driveBuffer, 1, (size_t) channel, polynomialPhases[(size_t) channel], numSamples);
+        break;
+    case Shaping::lookupTable:
+        // Until the shared tables are built the exact curves stand in
+        if (const auto* shaperTables = tables->getShaperTables()) {
+            kernels->distortTable(distortionAlgorithm, *shaperTables, data, driveBuffer, numSamples);
+            break;
+        }
+        // fall through
+    default:
+        kernels->distort(distortionAlgorithm, shaping != Shaping::approximate, data, driveBuffer, numSamples);
+        break;
+    }
+}
+
+void DistortionEngine::processMidSide(float* frames, const float* driveFrames, int numFrames) {
+    if (distortionAlgorithm == 4) {
+        // One quantizer per lane, from the drive at the end of the block
+        float numSteps[2], stepSize[2];
+        computeQuantizer(driveFrames[numFrames * 2 - 2], numSteps[0], stepSize[0]);
+        computeQuantizer(driveFrames[numFrames * 2 - 1], numSteps[1], stepSize[1]);
+
+        decimator.processMidSide(frames, numFrames, numSteps, stepSize);
+        return;
+    }
+
+    if (distortionAlgorithm == 5) {
+        kernels->diodeClipper(diodeCircuit, diodeStates.data(), frames, driveFrames, 2, numFrames);
+        return;
+    }
+
+    // The curves work sample by sample, so the lanes need nothing special,
+    // except the antiderivative that remembers the last sample of each
+    switch (shaping)
+    {
+    case Shaping::antiderivative:
+        processAntiderivative(frames, driveFrames, 2, previousInputs[0], numFrames);
+        processAntiderivative(frames + 1, driveFrames + 1, 2, previousInputs[1], numFrames);
+        break;
+    case Shaping::polynomial:
+        processPolynomial(frames, driveFrames, 2, 0, polynomialPhases[0], numFrames);
+        break;
+    case Shaping::lookupTable:
+        if (const auto* shaperTables = tables->getShaperTables()) {
+            kernels->distortTable(distortionAlgorithm, *shaperTables, frames, driveFrames, numFrames * 2);
+            break;
+        }
+        // fall through
+    default:
+        kernels->distort(distortionAlgorithm, shaping != Shaping::approximate, frames, driveFrames, numFrames * 2);
+        break;
+    }
+}
+
+void DistortionEngine::processLanes(float* frames, const float* driveFrames, int firstChannel, int numChannels, int numFrames) {
+    const int numLanes = kernels->laneGroupSize;
+
+    if (distortionAlgorithm == 4) {
+        // Each lane holds on its own, the empty ones are left alone
+        for (int lane = 0; lane < numChannels; ++lane) {
+            float numSteps, stepSize;
+            computeQuantizer(driveFrames[(numFrames - 1) * numLanes + lane], numSteps, stepSize);
+
+            decimator.processStrided(firstChannel + lane, frames + lane, numLanes, numFrames, numSteps, stepSize);
+        }
+        return;
+    }
+
+    if (distortionAlgorithm == 5) {
+        // The empty lanes run too, on silence, so the whole group stays in one vector
+        kernels->diodeClipper(diodeCircuit, &diodeStates[2 * (size_t) firstChannel], frames, driveFrames, numLanes, numFrames);
+        return;
+    }
+
+    switch (shaping)
+    {
+    case Shaping::antiderivative:
+        for (int lane = 0; lane < numChannels; ++lane)
+            processAntiderivative(frames + lane, driveFrames + lane, numLanes, previousInputs[(size_t) (firstChannel + lane)], numFrames);
+        break;
+    case Shaping::polynomial:
+        processPolynomial(frames, driveFrames, numLanes, (size_t) firstChannel, polynomialPhases[(size_t) firstChannel], numFrames);
+        break;
+    case Shaping::lookupTable:
+        if (const auto* shaperTables = tables->getShaperTables()) {
+            kernels->distortTable(distortionAlgorithm, *shaperTables, frames, driveFrames, numFrames * numLanes);
+            break;
+        }
+        // fall through
+    default:
+        // One call for the whole group, the curves don't care which lane is which
+        kernels->distort(distortionAlgorithm, shaping != Shaping::approximate, frames, driveFrames, numFrames * numLanes);
+        break;
+    }
+}
+
+bool DistortionEngine::getChainShaper(DSPKernels::ChainShaper& shaper) const {
+    // Hard Clip and Rectify have no tables, the table shaping runs them as they are
+    const bool exact = shaping == Shaping::exact;
+    const bool stateless = exact || shaping == Shaping::approximate
+                        || (shaping == Shaping::lookupTable && (distortionAlgorithm == 0 || distortionAlgorithm == 3));
+
+    if (!stateless)
+        return false;
+
+    switch (distortionAlgorithm)
+    {
+    case 0:
+        shaper = DSPKernels::ChainShaper::hardClip;
+        return true;
+    case 1:
+        shaper = exact ? DSPKernels::ChainShaper::tube : DSPKernels::ChainShaper::tubeFast;
+        return true;
+    case 2:
+        shaper = exact ? DSPKernels::ChainShaper::fuzz : DSPKernels::ChainShaper::fuzzFast;
+        return true;
+    case 3:
+        shaper = DSPKernels::ChainShaper::rectify;
+        return true;
+    default:
+        return false;
+    }
+}
+
+void DistortionEngine::processAntiderivative(float* data, const float* driveBuffer, int stride, float& previousInput, int numSamples) const {
+    // First order ADAA: the average of the curve between consecutive samples,
+    // from the difference of its antiderivative. Both samples go through the
+    // current drive, so a moving drive never gets mixed into the average.
+    // Done in double, the difference cancels most of the antiderivative.
+    const int algorithm = distortionAlgorithm;
+
+    auto antiderivative = [algorithm](double u) {
+        const double a = std::abs(u);
+        const double clipped = a <= 1.0 ? 0.5 * a * a : a - 0.5;
+
+        switch (algorithm)
+        {
+        case 1:
+            return a + std::log1p(std::exp(-2.0 * a)) - 0.69314718055994531; // log(cosh(u)), minus ln 2
+        case 2:
+            return a + std::exp(-a) - 1.0;
+        case 3:
+            return std::copysign(clipped, u);
+        default:
+            return clipped;
+        }
+    };
+
+    for (int i = 0; i < numSamples; ++i) {
+        float& sample = data[i * stride];
+        const double d = driveBuffer[i * stride];
+
+        // Same gain and makeup as the plain curves
+        const double gain = (algorithm == 1 || algorithm == 2) ? d : d + 1.0;
+        const double makeup = algorithm == 1 ? 1.0 / std::tanh(d)
+                            : algorithm == 2 ? 1.0 / (1.0 - std::exp(-d))
+                            : 1.0;
+
+        const double u0 = previousInput * gain;
+        const double u1 = sample * gain;
+        const double du = u1 - u0;
+
+        const double x = 0.5 * ((double) previousInput + sample);
+
+        previousInput = sample;
+
+        sample = std::abs(du) > 1.0e-6 ? (float) ((antiderivative(u1) - antiderivative(u0)) / du * makeup)
+                                       : (float) shapeExact(algorithm, x, d);
+    }
+}
+
+double DistortionEngine::shapeExact(int algorithm, double sample, double drive) {
+    switch (algorithm)
+    {
+    case 1:
+        return std::tanh(sample * drive) / std::tanh(drive);
+    case 2:
+        return std::copysign((1.0 - std::exp(-std::abs(sample * drive))) / (1.0 - std::exp(-drive)), sample);
+    case 3:
+        return std::min(std::abs(sample) * (drive + 1.0), 1.0);
+    case 5:
+        // Where the capacitor has settled, so the diode clipper's curve at DC
+        return diodeStaticVoltage(sample * drive, diodeResistance) / diodeStaticVoltage(drive, diodeResistance);
+    default:
+        return juce::jlimit(-1.0, 1.0, sample * (drive + 1.0));
+    }
+}
+
+double DistortionEngine::diodeStaticVoltage(double sourceVoltage, double resistance) {
+    // The same closed form the kernel uses, with omega solved to double precision
+    auto wrightOmega = [](double x) {
+        double w = x < 1.0 ? std::exp(x) : x - std::log(x);
+
+        for (int i = 0; i < 8; ++i)
+            w -= (w + std::log(w) - x) / (1.0 + 1.0 / w);
+
+        return w;
+    };
+
+    const double rIs = resistance * diodeSaturationCurrent;
+    const double vt = diodeThermalVoltage;
+    const double magnitude = std::abs(sourceVoltage);
+
+    return std::copysign(magnitude + rIs - vt * wrightOmega(magnitude / vt + std::log(rIs / vt) + rIs / vt), sourceVoltage);
+}
+
+void DistortionEngine::processPolynomial(float* data, const float* driveBuffer, int numLanes, size_t firstFit, int& phase, int numFrames) {
+    auto& first = polynomialFits[firstFit];
+    auto& last = polynomialFits[firstFit + (size_t) numLanes - 1];
+
+    for (int start = 0; start < numFrames;) {
+        const int length = juce::jmin(numFrames - start, polynomialRefitInterval - phase);
+
+        // On the grid the drive is picked up, in between only a new algorithm
+        // or degree gets a refit
+        updatePolynomialFit(first, phase == 0 ? driveBuffer[start * numLanes] : first.drive);
+        updatePolynomialFit(last, phase == 0 ? driveBuffer[start * numLanes + numLanes - 1] : last.drive);
+
+        kernels->chebyshev(first.coefficients.data(), last.coefficients.data(), polynomialDegree + 1,
+                           data + start * numLanes, length * numLanes);
+
+        phase = (phase + length) % polynomialRefitInterval;
+        start += length;
+    }
+}
+
+void DistortionEngine::updatePolynomialFit(PolynomialFit& fit, float fitDrive) {
+    if (fit.algorithm == distortionAlgorithm && fit.degree == polynomialDegree && fit.drive == fitDrive)
+        return;
+
+    fit.algorithm = distortionAlgorithm;
+    fit.degree = polynomialDegree;
+    fit.drive = fitDrive;
+
+    // Interpolating at the Chebyshev nodes, which is within a hair of the best
+    // fit there is for the degree, and only takes degree + 1 curve evaluations
+    const int numNodes = polynomialDegree + 1;
+    double values[DSPKernels::maxChebyshevCoefficients];
+
+    for (int j = 0; j < numNodes; ++j)
+        values[j] = shapeExact(distortionAlgorithm, chebyshevBasis[1][(size_t) j], fitDrive);
+
+    for (int k = 0; k < numNodes; ++k) {
+        double sum = 0.0;
+
+        for (int j = 0; j < numNodes; ++j)
+            sum += values[j] * chebyshevBasis[(size_t) k][(size_t) j];
+
+        fit.coefficients[(size_t) k] = (float) (sum * (k == 0 ? 1.0 : 2.0) / numNodes);
+    }
+}
+
 float sign(float x) {
     if (x >= 0) return 1.0;
     return -1.0;
@@ -69,11 +425,24 @@ float DistortionEngine::rectify(float x) {
     return hardClip(abs(x));
 }
 
+float DistortionEngine::diode(float x) {
+    return (float) shapeExact(5, x, getDrive());
+}
+
 float DistortionEngine::downsample(float x) {
-    int numSteps = std::round(64.0f - (getDrive() / 20.0f) * 60.0f); // Get the number of steps based on drive (from 64 to 4)
-    numSteps = std::max(numSteps, 4); // Ensure it doesn't go below 4 steps
+    return std::round(x * quantizerSteps) * quantizerStepSize;
+}
+
+void DistortionEngine::updateQuantizer() {
+    computeQuantizer(getDrive(), quantizerSteps, quantizerStepSize);
+}
+
+void DistortionEngine::computeQuantizer(float totalDrive, float& numSteps, float& stepSize) {
+    int steps = std::round(64.0f - (totalDrive / 20.0f) * 60.0f); // Get the number of steps based on drive (from 64 to 4)
+    steps = std::max(steps, 4); // Ensure it doesn't go below 4 steps
 
-    return std::round(x * numSteps) / numSteps;
+    numSteps = (float) steps;
+    stepSize = 1.0f / numSteps;
 }
 
 float DistortionEngine::distort(float sample) {
@@ -89,5 +458,7 @@ float DistortionEngine::distort(float sample) {
         return rectify(sample);
     case 4:
         return downsample(sample);
+    case 5:
+        return diode(sample);
     }
 }
\ No newline at end of file
@@ -2,26 +2,93 @@
 
 #define _USE_MATH_DEFINES
 
+#include <array>
 #include <vector>
 #include <JuceHeader.h>
 #include <cmath>
+#include "DSPKernels.h"
+#include "Decimator.h"
+#include "DSPTables.h"
 
 class DistortionEngine {
 public:
+	// How Tube, Fuzz, Hard Clip and Rectify get computed
+	enum class Shaping {
+		lookupTable,    // Tube and Fuzz interpolated from the shared tables
+		approximate,    // cheaper tanh and exp approximations
+		exact,          // exact tanh and exp
+		antiderivative, // exact, with first order antiderivative anti-aliasing
+		polynomial      // the curve at the current drive fitted with a Chebyshev polynomial
+	};
+
+	// A polynomial of degree N makes harmonics up to N only. With this degree
+	// every one of them folds back above the original Nyquist at the given
+	// oversampling factor, where the downsampling filter takes it out.
+	static int getAliasFreeDegree(int oversamplingFactor);
+
+	// The Diode algorithm's circuit: the drive as a source behind a resistor,
+	// a capacitor to ground and an antiparallel pair of silicon diodes
+	static constexpr double diodeResistance = 2200.0;
+	static constexpr double diodeCapacitance = 10.0e-9;
+	static constexpr double diodeSaturationCurrent = 2.52e-9;
+	static constexpr double diodeThermalVoltage = 0.02585 * 1.752; // times the ideality factor
+
+	// That circuit worked out for the diode clipper kernel at one sample rate
+	static DSPKernels::DiodeClipper getDiodeClipper(double sampleRate);
+
+	// The modulated drive is held in here. At 0 Tube, Fuzz and Diode divide 0 by 0,
+	// and below it Hard Clip and Fuzz turn the signal upside down.
+	static constexpr float minDrive = 0.01f;
+	static constexpr float maxDrive = 40.0f;
+
 	DistortionEngine();
 
+	void prepare(int numChannels);
+
+	void setKernels(const DSPKernels::KernelTable& newKernels);
+
 	void setDistortionAlgorithm(int algoritm);
 
 	void setDrive(float newDrive);
 
 	void setModulation(float newModulation);
 
+	// Sample rate reduction used by the Downsample algorithm
+	void setDownsampleFactor(float newFactor);
+
+	void setDownsampleBandLimited(bool shouldBeBandLimited);
+
+	void setShaping(Shaping newShaping);
+
+	// The rate the curves run at, oversampling included. Only the Diode algorithm's
+	// capacitor cares, the shaping modes don't apply to it either.
+	void setSampleRate(double sampleRate);
+
+	// For the polynomial shaping, up to DSPKernels::maxChebyshevCoefficients - 1
+	void setPolynomialDegree(int degree);
+
 	float getDrive();
 
 	std::vector<float> getWaveshape();
 
 	float processSample(float sample);
 
+	// Fills driveOut with the modulated drive for a block of modulation values
+	void computeDrive(const float* modulation, float* driveOut, int numSamples) const;
+
+	void processBlock(int channel, float* data, const float* driveBuffer, int numSamples);
+
+	// Interleaved mid/side frames, driveFrames holds a drive per lane
+	void processMidSide(float* frames, const float* driveFrames, int numFrames);
+
+	// A group of channels packed by the kernels' packLanes, numChannels of its
+	// lanes in use starting at firstChannel. driveFrames is packed the same way.
+	void processLanes(float* frames, const float* driveFrames, int firstChannel, int numChannels, int numFrames);
+
+	// The current curve as one of the fused chain's shapers. False when it needs more than
+	// a stateless curve per sample: Downsample, Diode, the tables, antiderivative or polynomial.
+	bool getChainShaper(DSPKernels::ChainShaper& shaper) const;
+
 private:
 	float hardClip(float sample);
 
@@ -33,10 +100,69 @@ private:
 
 	float downsample(float sample);
 
+	float diode(float sample);
+
 	float distort(float sample);
 
+	// Works out the Downsample quantizer from the current drive
+	void updateQuantizer();
+
+	// The curves with antiderivative anti-aliasing, over every stride-th sample
+	void processAntiderivative(float* data, const float* driveBuffer, int stride, float& previousInput, int numSamples) const;
+
+	static void computeQuantizer(float totalDrive, float& numSteps, float& stepSize);
+
+	// The curves in double with their makeup gain, the reference the others are held to
+	static double shapeExact(int algorithm, double sample, double drive);
+
+	// Voltage across the pair for a source of the given resistance, without the capacitor
+	static double diodeStaticVoltage(double sourceVoltage, double resistance);
+
+	struct PolynomialFit {
+		int algorithm = -1;
+		int degree = 0;
+		float drive = 0.0f;
+		std::array<float, DSPKernels::maxChebyshevCoefficients> coefficients {};
+	};
+
+	// Refits when the algorithm, degree or drive moved since the last time
+	void updatePolynomialFit(PolynomialFit& fit, float fitDrive);
+
+	// The fitted curves over interleaved lanes, one fit per lane starting at firstFit
+	void processPolynomial(float* data, const float* driveBuffer, int numLanes, size_t firstFit, int& phase, int numFrames);
+
+	// A fit only holds one drive, so a modulated drive moves in steps this many
+	// samples apart. Counted from prepare(), wherever the blocks start and end.
+	static constexpr int polynomialRefitInterval = 32;
+
+	const DSPKernels::KernelTable* kernels;
+
 	int distortionAlgorithm;
 	float drive;
 	float modulation; // from 0.0 - 1.0
+	Shaping shaping;
+
+	juce::SharedResourcePointer<DSPTables> tables;
+
+	// Last input per channel or mid/side lane, for the antiderivative shaping
+	std::vector<float> previousInputs;
+
+	// One fit and refit phase per channel, mid/side uses the first two fits
+	// and the first phase
+	int polynomialDegree;
+	std::vector<PolynomialFit> polynomialFits;
+	std::vector<int> polynomialPhases;
+
+	// cos(pi * k * (j + 0.5) / n) for the n = degree + 1 Chebyshev nodes
+	std::array<std::array<float, DSPKernels::maxChebyshevCoefficients>, DSPKernels::maxChebyshevCoefficients> chebyshevBasis;
+
+	// The circuit at the current sample rate and each channel's two capacitors,
+	// the clipper's and its makeup's, in pairs laid out like previousInputs
+	DSPKernels::DiodeClipper diodeCircuit;
+	std::vector<float> diodeStates;
+
+	Decimator decimator;
+	float quantizerSteps;
+	float quantizerStepSize;
 
 };
\ No newline at end of file
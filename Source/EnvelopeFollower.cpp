@@ -1,9 +1,13 @@
 #include "EnvelopeFollower.h"
+#include "TraceRecorder.h"
+#include <algorithm>
 #include <cmath>
 
 EnvelopeFollower::EnvelopeFollower(float attackTime, float releaseTime, float sampleRate)
-    : attackTime(attackTime), releaseTime(releaseTime), sampleRate(sampleRate), envelope(0.0f)
+    : attackTime(attackTime), releaseTime(releaseTime), gate(0.0f), sampleRate(sampleRate), envelope(0.0f),
+      kernels(&DSPKernels::getKernels(DSPKernels::InstructionSet::scalar))
 {
+    history.setSampleRate(sampleRate);
     updateCoefficients();
 }
 
@@ -26,6 +30,7 @@ void EnvelopeFollower::setGate(float g) {
 void EnvelopeFollower::setSampleRate(float rate)
 {
     sampleRate = rate;
+    history.setSampleRate(rate);
     updateCoefficients();
 }
 
@@ -38,23 +43,87 @@ float EnvelopeFollower::process(float input)
     else
         envelope = releaseCoef * envelope + (1.0f - releaseCoef) * absInput; // Release phase
 
-    if (++sampleCounter >= 255)
+    history.push(&envelope, 1);
+
+    return envelope;
+}
+
+void EnvelopeFollower::processBlock(const float* const* channels, int numChannels, float* envelopeOut, int numSamples)
+{
+    // Also writes the history the editor draws from
+    IGNITION_TRACE_ZONE("envelope follower");
+
+    if (detectorInterval > 1)
+        processDecimated(channels, numChannels, envelopeOut, numSamples);
+    else
+        envelope = kernels->envelope(channels, numChannels, envelopeOut, numSamples, envelope, attackCoef, releaseCoef, gate);
+
+    history.push(envelopeOut, numSamples);
+}
+
+void EnvelopeFollower::processDecimated(const float* const* channels, int numChannels, float* envelopeOut, int numSamples)
+{
+    for (int start = 0; start < numSamples;)
     {
-        envelopeHistory.push_back(envelope);
-        sampleCounter = 0;  // Reset the counter
+        // As much of the group in progress as this block holds
+        const int length = std::min(detectorInterval - groupPosition, numSamples - start);
+
+        // Linked peak over the group, so short transients still get caught
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = start; i < start + length; ++i)
+                groupPeak = std::max(groupPeak, std::abs(channels[channel][i]));
+
+        for (int i = 0; i < length; ++i)
+            envelopeOut[start + i] = rampStart + rampStep * (float) (groupPosition + i + 1);
+
+        start += length;
+        groupPosition += length;
+
+        if (groupPosition < detectorInterval)
+            break;
+
+        // Holding the peak for the whole group, the smoother lands where it
+        // would have after stepping sample by sample
+        const float coef = (groupPeak > envelope && groupPeak > gate) ? groupAttackCoef : groupReleaseCoef;
+        const float target = coef * envelope + (1.0f - coef) * groupPeak;
+
+        rampStart = envelope;
+        rampStep = (target - envelope) / (float) detectorInterval;
+        envelope = target;
+
+        groupPeak = 0.0f;
+        groupPosition = 0;
     }
+}
+
+void EnvelopeFollower::setKernels(const DSPKernels::KernelTable& newKernels)
+{
+    kernels = &newKernels;
+}
+
+void EnvelopeFollower::setDetectorInterval(int interval)
+{
+    interval = std::clamp(interval, 1, maxDetectorInterval);
 
-    if (envelopeHistory.size() > historySize) envelopeHistory.erase(envelopeHistory.begin());
+    if (interval == detectorInterval)
+        return;
 
-    return envelope;
+    // Start a fresh group, holding wherever the envelope got to
+    detectorInterval = interval;
+    groupPeak = 0.0f;
+    groupPosition = 0;
+    rampStart = envelope;
+    rampStep = 0.0f;
+
+    updateCoefficients();
 }
 
 float EnvelopeFollower::getEnvelope() const {
     return envelope;
 }
 
-std::vector<float>& EnvelopeFollower::getEnvelopeHistory() {
-    return envelopeHistory;
+const EnvelopeHistory& EnvelopeFollower::getEnvelopeHistory() const {
+    return history;
 }
 
 float EnvelopeFollower::getGate() const {
@@ -65,4 +134,7 @@ void EnvelopeFollower::updateCoefficients()
 {
     attackCoef = std::exp(-std::log(9.0f) / (attackTime * sampleRate));
     releaseCoef = std::exp(-std::log(9.0f) / (releaseTime * sampleRate));
+
+    groupAttackCoef = std::pow(attackCoef, (float) detectorInterval);
+    groupReleaseCoef = std::pow(releaseCoef, (float) detectorInterval);
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <vector>
+#include "DSPKernels.h"
+#include "EnvelopeHistory.h"
 
 class EnvelopeFollower
 {
@@ -12,15 +14,27 @@ public:
 	void setSampleRate(float rate);
 	void setGate(float g);
 
+	void setKernels(const DSPKernels::KernelTable& newKernels);
+
+	// Run the smoother once every this many samples, on the peak of the group,
+	// and ramp to it over the next group. 1 is every sample. Groups are counted
+	// across blocks, so the envelope doesn't depend on how the host splits them.
+	static constexpr int maxDetectorInterval = 16;
+	void setDetectorInterval(int interval);
+
 	float process(float input);
 
+	// Runs one linked envelope over all channels, writing one value per frame
+	void processBlock(const float* const* channels, int numChannels, float* envelopeOut, int numSamples);
+
 	float getEnvelope() const;
 	float getGate() const;
 
-	std::vector<float>& getEnvelopeHistory();
+	const EnvelopeHistory& getEnvelopeHistory() const;
 
 private:
 	void updateCoefficients();
+	void processDecimated(const float* const* channels, int numChannels, float* envelopeOut, int numSamples);
 
 	float attackTime, releaseTime;
 	float gate;
@@ -28,7 +42,17 @@ private:
 	float attackCoef, releaseCoef;
 	float envelope;
 
-	std::vector<float> envelopeHistory;
-	const int historySize = 512;
-	int sampleCounter = 0;
+	// The coefficients raised to the power of the group length, so one step
+	// covers a whole group
+	int detectorInterval = 1;
+	float groupAttackCoef = 1.0f, groupReleaseCoef = 1.0f;
+
+	// The group in progress, and the ramp out of the last one
+	float groupPeak = 0.0f;
+	int groupPosition = 0;
+	float rampStart = 0.0f, rampStep = 0.0f;
+
+	const DSPKernels::KernelTable* kernels;
+
+	EnvelopeHistory history;
 };
\ No newline at end of file
@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+    EnvelopeHistory.cpp
+    Created: 19 Oct 2026 11:52:36pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#include "EnvelopeHistory.h"
+
+EnvelopeHistory::EnvelopeHistory() {
+    int interval = finestInterval;
+
+    for (auto& level : levels) {
+        // One spare, so a read racing a write doesn't see its newest point overwritten
+        level.capacity = (int) std::ceil(historySeconds * maxSampleRate / interval) + 1;
+        level.interval = interval;
+        level.points = std::make_unique<Point[]>((size_t) level.capacity);
+
+        interval *= levelRatio;
+    }
+}
+
+void EnvelopeHistory::setSampleRate(double newSampleRate) {
+    sampleRate.store(newSampleRate, std::memory_order_relaxed);
+
+    for (auto& level : levels) {
+        level.numWritten.store(0, std::memory_order_release);
+        level.numPending = 0;
+    }
+}
+
+double EnvelopeHistory::getSampleRate() const noexcept {
+    return sampleRate.load(std::memory_order_relaxed);
+}
+
+void EnvelopeHistory::push(const float* values, int numSamples) noexcept {
+    Level& finest = levels[0];
+
+    for (int i = 0; i < numSamples;) {
+        // The rest of the current point in one go
+        const int length = juce::jmin(finestInterval - finest.numPending, numSamples - i);
+        const auto range = juce::FloatVectorOperations::findMinAndMax(values + i, length);
+
+        if (finest.numPending == 0)
+            finest.pending = { range.getStart(), range.getEnd() };
+        else
+            finest.pending = { juce::jmin(finest.pending.min, range.getStart()), juce::jmax(finest.pending.max, range.getEnd()) };
+
+        finest.numPending += length;
+        i += length;
+
+        if (finest.numPending == finestInterval) {
+            finest.numPending = 0;
+            append(0, finest.pending);
+        }
+    }
+}
+
+void EnvelopeHistory::append(int levelIndex, Range range) noexcept {
+    Level& level = levels[(size_t) levelIndex];
+    const juce::int64 index = level.numWritten.load(std::memory_order_relaxed);
+
+    Point& point = level.points[(size_t) (index % level.capacity)];
+    point.min.store(range.min, std::memory_order_relaxed);
+    point.max.store(range.max, std::memory_order_relaxed);
+
+    level.numWritten.store(index + 1, std::memory_order_release);
+
+    // Every levelRatio points make one on the level above
+    if (levelIndex + 1 < numLevels) {
+        Level& next = levels[(size_t) levelIndex + 1];
+
+        if (next.numPending == 0)
+            next.pending = range;
+        else
+            next.pending = { juce::jmin(next.pending.min, range.min), juce::jmax(next.pending.max, range.max) };
+
+        if (++next.numPending == levelRatio) {
+            next.numPending = 0;
+            append(levelIndex + 1, next.pending);
+        }
+    }
+}
+
+void EnvelopeHistory::read(double seconds, Range* pixels, int numPixels) const noexcept {
+    if (numPixels <= 0)
+        return;
+
+    const double samplesPerPixel = juce::jmax(1.0, seconds * getSampleRate() / numPixels);
+
+    // The coarsest level that still has a point per pixel, so each pixel
+    // looks at fewer than levelRatio points
+    int levelIndex = 0;
+
+    while (levelIndex + 1 < numLevels && levels[(size_t) levelIndex + 1].interval <= samplesPerPixel)
+        ++levelIndex;
+
+    const Level& level = levels[(size_t) levelIndex];
+    const double pointsPerPixel = samplesPerPixel / level.interval;
+
+    const juce::int64 numWritten = level.numWritten.load(std::memory_order_acquire);
+    const juce::int64 oldest = juce::jmax((juce::int64) 0, numWritten - (level.capacity - 1));
+    const double first = (double) numWritten - pointsPerPixel * numPixels;
+
+    for (int pixel = 0; pixel < numPixels; ++pixel) {
+        // Every point that overlaps the pixel, so no peak falls between two of them
+        const auto start = (juce::int64) std::floor(first + pointsPerPixel * pixel);
+        const auto end = (juce::int64) std::ceil(first + pointsPerPixel * (pixel + 1));
+
+        Range range { 0.0f, 0.0f };
+        bool empty = true;
+
+        for (juce::int64 index = juce::jmax(start, oldest); index < juce::jmin(end, numWritten); ++index) {
+            const Point& point = level.points[(size_t) (index % level.capacity)];
+            const float min = point.min.load(std::memory_order_relaxed);
+            const float max = point.max.load(std::memory_order_relaxed);
+
+            range = empty ? Range { min, max } : Range { juce::jmin(range.min, min), juce::jmax(range.max, max) };
+            empty = false;
+        }
+
+        pixels[pixel] = range;
+    }
+}
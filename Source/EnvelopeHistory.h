@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    EnvelopeHistory.h
+    Created: 19 Oct 2026 11:52:36pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <JuceHeader.h>
+
+// The envelope's recent past as min/max pairs at three resolutions, 32, 256
+// and 2048 samples per point, each covering the same historySeconds. The audio
+// thread pushes with constant work per sample, and the display reads whichever
+// level is closest to one point per pixel, so drawing costs the same at any zoom.
+// Everything is allocated up front, for sample rates up to maxSampleRate.
+class EnvelopeHistory {
+public:
+	struct Range {
+		float min;
+		float max;
+	};
+
+	static constexpr double historySeconds = 10.0;
+	static constexpr double maxSampleRate = 192000.0; // past this the history gets shorter
+	static constexpr int numLevels = 3;
+	static constexpr int finestInterval = 32; // samples per point on the finest level
+	static constexpr int levelRatio = 8;      // points per point on the next level up
+
+	EnvelopeHistory();
+
+	// Clears the history, the points no longer line up with time
+	void setSampleRate(double newSampleRate);
+	double getSampleRate() const noexcept;
+
+	// Audio thread
+	void push(const float* values, int numSamples) noexcept;
+
+	// Any thread. One range per pixel over the last seconds, oldest first, empty
+	// where nothing has been pushed yet. Points still being filled aren't included.
+	void read(double seconds, Range* pixels, int numPixels) const noexcept;
+
+private:
+	struct Point {
+		std::atomic<float> min { 0.0f };
+		std::atomic<float> max { 0.0f };
+	};
+
+	struct Level {
+		std::unique_ptr<Point[]> points;
+		int capacity = 0;
+		int interval = 0; // samples per point
+		std::atomic<juce::int64> numWritten { 0 };
+
+		// What goes into the next point, audio thread only
+		Range pending { 0.0f, 0.0f };
+		int numPending = 0;
+	};
+
+	void append(int level, Range range) noexcept;
+
+	std::array<Level, numLevels> levels;
+	std::atomic<double> sampleRate { 44100.0 };
+
+	JUCE_DECLARE_NON_COPYABLE(EnvelopeHistory)
+};
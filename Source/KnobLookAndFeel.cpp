@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    KnobLookAndFeel.cpp
+    Created: 20 Oct 2026 12:21:08am
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#include "KnobLookAndFeel.h"
+#include "TraceRecorder.h"
+
+KnobLookAndFeel::KnobLookAndFeel() {
+
+}
+
+KnobLookAndFeel::Strip& KnobLookAndFeel::getStrip(int width, int height, float scale, float startAngle, float endAngle,
+                                                  const juce::Slider& slider) {
+    const auto fill = slider.findColour(juce::Slider::rotarySliderFillColourId).getARGB();
+    const auto outline = slider.findColour(juce::Slider::rotarySliderOutlineColourId).getARGB();
+    const auto thumb = slider.findColour(juce::Slider::thumbColourId).getARGB();
+
+    for (auto it = strips.begin(); it != strips.end(); ++it) {
+        if (it->width == width && it->height == height && it->scale == scale && it->startAngle == startAngle
+            && it->endAngle == endAngle && it->fill == fill && it->outline == outline && it->thumb == thumb) {
+            std::rotate(strips.begin(), it, it + 1);
+            return strips.front();
+        }
+    }
+
+    if ((int) strips.size() >= maxStrips)
+        strips.pop_back();
+
+    strips.insert(strips.begin(), { width, height, scale, startAngle, endAngle, fill, outline, thumb, std::vector<juce::Image>((size_t) numFrames) });
+    return strips.front();
+}
+
+void KnobLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height, float sliderPosProportional,
+                                       float rotaryStartAngle, float rotaryEndAngle, juce::Slider& slider) {
+    if (width <= 0 || height <= 0)
+        return;
+
+    // Rendered at the physical resolution, so a frame is never scaled on a retina screen
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    auto& strip = getStrip(width, height, scale, rotaryStartAngle, rotaryEndAngle, slider);
+
+    const int index = juce::jlimit(0, numFrames - 1, juce::roundToInt(sliderPosProportional * (numFrames - 1)));
+    auto& frame = strip.frames[(size_t) index];
+
+    if (!frame.isValid()) {
+        IGNITION_TRACE_ZONE("render knob frame");
+
+        frame = juce::Image(juce::Image::ARGB, juce::roundToInt(width * scale), juce::roundToInt(height * scale), true);
+
+        juce::Graphics frameGraphics(frame);
+        frameGraphics.addTransform(juce::AffineTransform::scale(scale));
+
+        LookAndFeel_V4::drawRotarySlider(frameGraphics, 0, 0, width, height, index / (float) (numFrames - 1),
+                                         rotaryStartAngle, rotaryEndAngle, slider);
+    }
+
+    g.drawImage(frame, juce::Rectangle<int>(x, y, width, height).toFloat());
+}
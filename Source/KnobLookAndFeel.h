@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+    KnobLookAndFeel.h
+    Created: 20 Oct 2026 12:21:08am
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <JuceHeader.h>
+
+// The stock V4 knobs, drawn once per size, scale factor and colour scheme into
+// a strip of frames, then blitted. Frames are rendered the first time they're
+// needed, and the strips are shared by every editor through a SharedResourcePointer,
+// so a session full of open windows draws each frame once.
+class KnobLookAndFeel : public juce::LookAndFeel_V4 {
+public:
+	// Positions a knob can show, about 4 degrees apart over the stock arc
+	static constexpr int numFrames = 64;
+
+	// Strips kept at once. Every resize or scale change makes new ones, past this
+	// the least recently used goes.
+	static constexpr int maxStrips = 8;
+
+	KnobLookAndFeel();
+
+	void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height, float sliderPosProportional,
+	                      float rotaryStartAngle, float rotaryEndAngle, juce::Slider& slider) override;
+
+private:
+	struct Strip {
+		int width, height;
+		float scale;
+		float startAngle, endAngle;
+		juce::uint32 fill, outline, thumb;
+
+		std::vector<juce::Image> frames; // empty images until first drawn
+	};
+
+	Strip& getStrip(int width, int height, float scale, float startAngle, float endAngle, const juce::Slider& slider);
+
+	std::vector<Strip> strips; // most recently used first
+
+	JUCE_DECLARE_NON_COPYABLE(KnobLookAndFeel)
+};
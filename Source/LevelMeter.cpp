@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    LevelMeter.cpp
+    Created: 19 Oct 2026 10:41:05pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#include "LevelMeter.h"
+
+LevelMeter::LevelMeter()
+    : kernels(&DSPKernels::getKernels(DSPKernels::InstructionSet::scalar)) {
+}
+
+void LevelMeter::setKernels(const DSPKernels::KernelTable& newKernels) {
+    kernels = &newKernels;
+}
+
+void LevelMeter::prepare(double newSampleRate, int numChannels, int newMaxBlockSize) {
+    sampleRate = newSampleRate;
+    maxBlockSize = newMaxBlockSize;
+
+    truePeakWindows.assign((size_t) numChannels, std::vector<float>((size_t) (truePeakTaps - 1 + maxBlockSize), 0.0f));
+
+    heldPeak = heldTruePeak = meanSquare = 0.0f;
+    peak.store(0.0f, std::memory_order_relaxed);
+    truePeak.store(0.0f, std::memory_order_relaxed);
+    rms.store(0.0f, std::memory_order_relaxed);
+}
+
+const float* LevelMeter::getTruePeakCoefficients() {
+    // Blackman windowed sinc at 1/4, 2/4 and 3/4 of the way from the sixth
+    // tap to the seventh, each phase normalised to unity gain at DC
+    static const auto coefficients = [] {
+        std::array<float, truePeakPhases * truePeakTaps> c {};
+
+        for (int phase = 0; phase < truePeakPhases; ++phase) {
+            const double fraction = (phase + 1) / (double) (truePeakPhases + 1);
+            double sum = 0.0;
+
+            for (int k = 0; k < truePeakTaps; ++k) {
+                const double t = (truePeakTaps / 2 - 1 - k) + fraction;
+                const double w = t / (truePeakTaps / 2);
+                const double window = 0.42 + 0.5 * std::cos(juce::MathConstants<double>::pi * w)
+                                    + 0.08 * std::cos(juce::MathConstants<double>::twoPi * w);
+                const double sinc = std::sin(juce::MathConstants<double>::pi * t) / (juce::MathConstants<double>::pi * t);
+
+                c[(size_t) (phase * truePeakTaps + k)] = (float) (sinc * window);
+                sum += sinc * window;
+            }
+
+            for (int k = 0; k < truePeakTaps; ++k)
+                c[(size_t) (phase * truePeakTaps + k)] = (float) (c[(size_t) (phase * truePeakTaps + k)] / sum);
+        }
+
+        return c;
+    }();
+
+    return coefficients.data();
+}
+
+void LevelMeter::process(const float* const* channels, int numChannels, int numSamples) noexcept {
+    if (maxBlockSize <= 0)
+        return;
+
+    const float* coefficients = getTruePeakCoefficients();
+    numChannels = juce::jmin(numChannels, (int) truePeakWindows.size());
+
+    for (int start = 0; start < numSamples; start += maxBlockSize) {
+        const int length = juce::jmin(maxBlockSize, numSamples - start);
+
+        float blockPeak = 0.0f, blockTruePeak = 0.0f, blockSum = 0.0f;
+
+        for (int channel = 0; channel < numChannels; ++channel) {
+            const float* data = channels[channel] + start;
+
+            float channelPeak, channelSum;
+            kernels->levels(data, length, channelPeak, channelSum);
+
+            blockPeak = juce::jmax(blockPeak, channelPeak);
+            blockSum += channelSum;
+
+            // Append the block to the history, interpolate, then keep the tail for next time
+            float* window = truePeakWindows[(size_t) channel].data();
+            std::copy(data, data + length, window + truePeakTaps - 1);
+
+            blockTruePeak = juce::jmax(blockTruePeak, kernels->polyphasePeak(window, coefficients, truePeakPhases, truePeakTaps, length));
+
+            std::copy(window + length, window + length + truePeakTaps - 1, window);
+        }
+
+        // The samples themselves count too, the filter only fills in between
+        blockTruePeak = juce::jmax(blockTruePeak, blockPeak);
+
+        const float fall = std::pow(10.0f, -peakFallRate / 20.0f * (float) length / (float) sampleRate);
+        heldPeak = juce::jmax(blockPeak, heldPeak * fall);
+        heldTruePeak = juce::jmax(blockTruePeak, heldTruePeak * fall);
+
+        const float blockMeanSquare = numChannels > 0 ? blockSum / (float) (numChannels * length) : 0.0f;
+        const float coef = std::exp(-(float) length / (rmsTime * (float) sampleRate));
+        meanSquare = coef * meanSquare + (1.0f - coef) * blockMeanSquare;
+    }
+
+    peak.store(heldPeak, std::memory_order_relaxed);
+    truePeak.store(heldTruePeak, std::memory_order_relaxed);
+    rms.store(std::sqrt(meanSquare), std::memory_order_relaxed);
+}
+
+LevelMeter::Reading LevelMeter::getReading() const noexcept {
+    return { peak.load(std::memory_order_relaxed), truePeak.load(std::memory_order_relaxed), rms.load(std::memory_order_relaxed) };
+}
+
+float LevelMeter::toDecibels(float level) noexcept {
+    return juce::Decibels::gainToDecibels(level, -60.0f);
+}
@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+
+    LevelMeter.h
+    Created: 19 Oct 2026 10:41:05pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <vector>
+#include <JuceHeader.h>
+#include "DSPKernels.h"
+
+// Peak, true peak and RMS of a signal, worked out once per block with the
+// vector kernels. The audio thread applies the meter ballistics and stores
+// the result in atomics, so the editor just loads them whenever it repaints.
+//
+// True peak is the largest magnitude at 4x the sample rate, in the spirit of
+// ITU-R BS.1770, which catches the overs between samples a plain peak misses.
+class LevelMeter {
+public:
+	// Linear, 1.0 is full scale. Peaks are held and fall at peakFallRate,
+	// RMS averages over rmsTime.
+	struct Reading {
+		float peak = 0.0f;
+		float truePeak = 0.0f;
+		float rms = 0.0f;
+	};
+
+	static constexpr float peakFallRate = 12.0f; // dB per second
+	static constexpr float rmsTime = 0.3f;       // seconds
+
+	// Interpolating filter, one set of taps for each position between two samples
+	static constexpr int truePeakPhases = 3;
+	static constexpr int truePeakTaps = 12;
+
+	LevelMeter();
+
+	void prepare(double sampleRate, int numChannels, int maxBlockSize);
+	void setKernels(const DSPKernels::KernelTable& newKernels);
+
+	// Audio thread. The true peak runs half the filter length behind.
+	void process(const float* const* channels, int numChannels, int numSamples) noexcept;
+
+	// Any thread
+	Reading getReading() const noexcept;
+
+	static float toDecibels(float level) noexcept;
+
+private:
+	static const float* getTruePeakCoefficients();
+
+	const DSPKernels::KernelTable* kernels;
+
+	// Per channel, the last truePeakTaps - 1 samples followed by room for a block
+	std::vector<std::vector<float>> truePeakWindows;
+	int maxBlockSize = 0;
+
+	double sampleRate = 44100.0;
+
+	// Owned by the audio thread
+	float heldPeak = 0.0f, heldTruePeak = 0.0f, meanSquare = 0.0f;
+
+	std::atomic<float> peak { 0.0f }, truePeak { 0.0f }, rms { 0.0f };
+};
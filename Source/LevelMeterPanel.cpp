@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    LevelMeterPanel.cpp
+    Created: 19 Oct 2026 10:58:37pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#include "LevelMeterPanel.h"
+
+namespace {
+    constexpr float lowestDecibels = -60.0f;
+}
+
+LevelMeterPanel::LevelMeterPanel(const LevelMeter& inputMeter, const LevelMeter& outputMeter)
+    : input(inputMeter), output(outputMeter) {
+    startTimerHz(30);
+}
+
+LevelMeterPanel::~LevelMeterPanel() {
+    stopTimer();
+}
+
+void LevelMeterPanel::timerCallback() {
+    const auto newInput = input.getReading();
+    const auto newOutput = output.getReading();
+
+    auto same = [](const LevelMeter::Reading& a, const LevelMeter::Reading& b) {
+        return a.peak == b.peak && a.truePeak == b.truePeak && a.rms == b.rms;
+    };
+
+    // Nothing moves while the host is stopped, so don't repaint for nothing
+    if (same(newInput, inputReading) && same(newOutput, outputReading))
+        return;
+
+    inputReading = newInput;
+    outputReading = newOutput;
+    repaint();
+}
+
+void LevelMeterPanel::drawMeter(juce::Graphics& g, const juce::String& name, const LevelMeter::Reading& reading, juce::Rectangle<int> area) const {
+    auto toX = [&](float level) {
+        const float decibels = LevelMeter::toDecibels(level);
+        return (float) area.getX() + (float) area.getWidth() * juce::jlimit(0.0f, 1.0f, (decibels - lowestDecibels) / -lowestDecibels);
+    };
+
+    g.setColour(juce::Colours::grey);
+    g.drawText(name, area.removeFromLeft(30), juce::Justification::centredLeft);
+
+    auto text = area.removeFromRight(50);
+    auto bar = area.reduced(0, 3).toFloat();
+
+    g.setColour(juce::Colours::darkgrey.darker());
+    g.fillRect(bar);
+
+    // RMS filled, peak as a line, red once the true peak goes over
+    g.setColour(juce::Colours::green);
+    g.fillRect(bar.withRight(toX(reading.rms)));
+
+    g.setColour(juce::Colours::white);
+    g.fillRect(juce::Rectangle<float>(toX(reading.peak) - 1.0f, bar.getY(), 2.0f, bar.getHeight()));
+
+    g.setColour(reading.truePeak >= 1.0f ? juce::Colours::red : juce::Colours::white);
+    g.drawText(juce::String(LevelMeter::toDecibels(reading.truePeak), 1), text, juce::Justification::centredRight);
+}
+
+void LevelMeterPanel::paint(juce::Graphics& g) {
+    g.fillAll(juce::Colours::black);
+    g.setFont(12.0f);
+
+    auto area = getLocalBounds().reduced(6);
+    const int rowHeight = area.getHeight() / 3;
+
+    drawMeter(g, "In", inputReading, area.removeFromTop(rowHeight));
+    drawMeter(g, "Out", outputReading, area.removeFromTop(rowHeight));
+
+    // The shaper squashes peaks, this is how far the output sits under the input
+    const float reduction = LevelMeter::toDecibels(inputReading.rms) - LevelMeter::toDecibels(outputReading.rms);
+
+    g.setColour(juce::Colours::grey);
+    g.drawText("GR " + juce::String(juce::jmax(0.0f, reduction), 1) + " dB   true peak dBTP", area, juce::Justification::centredLeft);
+}
@@ -0,0 +1,35 @@
+/*
+  ==============================================================================
+
+    LevelMeterPanel.h
+    Created: 19 Oct 2026 10:58:37pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "LevelMeter.h"
+
+// Input and output bars plus how much quieter the output is than the input.
+// Reads the meters' atomics at display rate and repaints only itself.
+class LevelMeterPanel : public juce::Component, private juce::Timer {
+public:
+	LevelMeterPanel(const LevelMeter& inputMeter, const LevelMeter& outputMeter);
+	~LevelMeterPanel() override;
+
+	void paint(juce::Graphics& g) override;
+
+private:
+	void timerCallback() override;
+	void drawMeter(juce::Graphics& g, const juce::String& name, const LevelMeter::Reading& reading, juce::Rectangle<int> area) const;
+
+	const LevelMeter& input;
+	const LevelMeter& output;
+
+	LevelMeter::Reading inputReading, outputReading;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LevelMeterPanel)
+};
@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    LoadMeterPanel.cpp
+    Created: 19 Oct 2026 9:48:12pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#include "LoadMeterPanel.h"
+
+#if IGNITION_DIAGNOSTICS
+
+LoadMeterPanel::LoadMeterPanel(StageProfiler& profilerToShow)
+    : profiler(profilerToShow) {
+    saveTraceButton.onClick = [this]
+    {
+        const auto file = TraceRecorder::getTraceDirectory()
+                              .getNonexistentChildFile("Ignition trace " + juce::Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S"), ".json", false);
+
+        const bool saved = TraceRecorder::writeChromeTrace(file);
+
+        juce::Logger::writeToLog("Ignition trace: " + juce::String(saved ? "saved to " : "couldn't write ") + file.getFullPathName());
+        saveTraceButton.setButtonText(saved ? "Saved " + file.getFileName() : "Couldn't save trace");
+    };
+    addAndMakeVisible(saveTraceButton);
+
+    startTimerHz(4);
+}
+
+LoadMeterPanel::~LoadMeterPanel() {
+    stopTimer();
+}
+
+void LoadMeterPanel::timerCallback() {
+    for (int stage = 0; stage < StageProfiler::numStages; ++stage)
+        summaries[(size_t) stage] = profiler.getSummary((StageProfiler::Stage) stage);
+
+    repaint();
+}
+
+void LoadMeterPanel::resized() {
+    saveTraceButton.setBounds(8, getHeight() - 38, getWidth() - 16, 30);
+}
+
+void LoadMeterPanel::mouseDown(const juce::MouseEvent&) {
+    profiler.reset();
+}
+
+void LoadMeterPanel::paint(juce::Graphics& g) {
+    g.fillAll(juce::Colours::black);
+    g.setFont(12.0f);
+
+    const int rowHeight = 18;
+    const int nameWidth = 70, columnWidth = 45;
+    int y = 10;
+
+    auto drawRow = [&](const juce::String& name, const juce::String& mean, const juce::String& p99, const juce::String& max) {
+        g.drawText(name, 8, y, nameWidth, rowHeight, juce::Justification::centredLeft);
+        g.drawText(mean, 8 + nameWidth, y, columnWidth, rowHeight, juce::Justification::centredRight);
+        g.drawText(p99, 8 + nameWidth + columnWidth, y, columnWidth, rowHeight, juce::Justification::centredRight);
+        g.drawText(max, 8 + nameWidth + columnWidth * 2, y, columnWidth, rowHeight, juce::Justification::centredRight);
+        y += rowHeight;
+    };
+
+    auto percent = [](double load) { return juce::String(load * 100.0, 2); };
+
+    g.setColour(juce::Colours::white);
+    g.drawText("DSP load, % of block", 8, y, getWidth() - 16, rowHeight, juce::Justification::centredLeft);
+    y += rowHeight + 4;
+
+    g.setColour(juce::Colours::grey);
+    drawRow("Stage", "mean", "p99", "max");
+
+    for (int stage = 0; stage < StageProfiler::numStages; ++stage) {
+        const auto& summary = summaries[(size_t) stage];
+
+        // Anything past the deadline is a dropout waiting to happen
+        g.setColour(summary.max >= 1.0 ? juce::Colours::red : juce::Colours::white);
+
+        if (stage == StageProfiler::total)
+            y += 4;
+
+        drawRow(StageProfiler::getStageName((StageProfiler::Stage) stage), percent(summary.mean), percent(summary.p99), percent(summary.max));
+    }
+
+    g.setColour(juce::Colours::grey);
+    y += 4;
+    g.drawText(juce::String(summaries[StageProfiler::total].numBlocks) + " blocks, click to reset", 8, y, getWidth() - 16, rowHeight,
+               juce::Justification::centredLeft);
+}
+
+#endif
@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+
+    LoadMeterPanel.h
+    Created: 19 Oct 2026 9:48:12pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "StageProfiler.h"
+#include "TraceRecorder.h"
+
+#if IGNITION_DIAGNOSTICS
+
+// The editor's diagnostics panel: mean, p99 and max load of every stage as a
+// percentage of the block deadline, refreshed a few times a second. Click it
+// to start counting again. Its button saves a Chrome trace of every thread
+// (see TraceRecorder).
+class LoadMeterPanel : public juce::Component, private juce::Timer {
+public:
+	static constexpr int preferredWidth = 220;
+
+	explicit LoadMeterPanel(StageProfiler& profilerToShow);
+	~LoadMeterPanel() override;
+
+	void paint(juce::Graphics& g) override;
+	void resized() override;
+	void mouseDown(const juce::MouseEvent& event) override;
+
+private:
+	void timerCallback() override;
+
+	StageProfiler& profiler;
+	std::array<StageProfiler::Summary, StageProfiler::numStages> summaries;
+
+	juce::TextButton saveTraceButton{ "Save trace" };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoadMeterPanel)
+};
+
+#endif
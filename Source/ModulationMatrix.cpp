@@ -0,0 +1,182 @@
+/*
+  ==============================================================================
+
+    ModulationMatrix.cpp
+    Created: 19 Oct 2026 4:02:37pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#include "ModulationMatrix.h"
+
+ModulationMatrix::ModulationMatrix()
+    : numRoutings(0), randomRate(1.0f), randomPhase(0.0f), randomFrom(0.0f), randomTo(0.0f), sampleRate(44100.0), bpm(120.0) {
+    clearRoutings();
+}
+
+void ModulationMatrix::prepare(double newSampleRate) {
+    sampleRate = newSampleRate;
+
+    // The same random values after every prepare, so a capture replays exactly
+    rng.setSeed(randomSeed);
+    reset();
+}
+
+void ModulationMatrix::reset() {
+    for (auto& lfo : lfos)
+        lfo.phase = 0.0f;
+
+    randomPhase = 0.0f;
+    randomFrom = 0.0f;
+    randomTo = rng.nextFloat() * 2.0f - 1.0f;
+}
+
+void ModulationMatrix::clearRoutings() {
+    numRoutings = 0;
+
+    std::fill(std::begin(sourceUsed), std::end(sourceUsed), false);
+    std::fill(std::begin(destinationActive), std::end(destinationActive), false);
+}
+
+void ModulationMatrix::addRouting(Source source, Destination destination, float depth) {
+    if (depth == 0.0f || numRoutings >= maxRoutings) {
+        jassert(numRoutings < maxRoutings);
+        return;
+    }
+
+    routings[(size_t) numRoutings++] = { source, destination, depth };
+    sourceUsed[source] = true;
+    destinationActive[destination] = true;
+}
+
+void ModulationMatrix::setLfo(int index, double beatsPerCycle, LfoShape shape) {
+    jassert(juce::isPositiveAndBelow(index, numLfos));
+
+    lfos[(size_t) index].beatsPerCycle = juce::jmax(1.0e-3, beatsPerCycle);
+    lfos[(size_t) index].shape = shape;
+}
+
+void ModulationMatrix::setRandomRate(float hz) {
+    randomRate = juce::jmax(0.0f, hz);
+}
+
+void ModulationMatrix::setTempo(double newBpm) {
+    if (newBpm > 0.0)
+        bpm = newBpm;
+}
+
+void ModulationMatrix::syncToPosition(double ppqPosition) {
+    for (auto& lfo : lfos) {
+        const double cycles = ppqPosition / lfo.beatsPerCycle;
+        lfo.phase = (float) (cycles - std::floor(cycles));
+    }
+}
+
+bool ModulationMatrix::isActive(Destination destination) const noexcept {
+    return destinationActive[destination];
+}
+
+void ModulationMatrix::process(ScratchArena& arena, const float* envelopeIn, int numSamples) {
+    float* lfoOut[numLfos] = { arena.getPointer(ScratchArena::sourceBuffer, 0), arena.getPointer(ScratchArena::sourceBuffer, 1) };
+    float* randomOut = arena.getPointer(ScratchArena::sourceBuffer, 2);
+
+    // Only the sources something listens to get rendered, the LFOs still
+    // have to move so they stay in time when they get routed again
+    for (int i = 0; i < numLfos; ++i) {
+        auto& lfo = lfos[(size_t) i];
+
+        if (sourceUsed[lfo1 + i]) {
+            renderLfo(lfo, lfoOut[i], numSamples);
+        }
+        else {
+            const float next = lfo.phase + getLfoIncrement(lfo) * (float) numSamples;
+            lfo.phase = next - std::floor(next);
+        }
+    }
+
+    if (sourceUsed[random])
+        renderRandom(randomOut, numSamples);
+
+    const float* sources[numSources] = { envelopeIn, lfoOut[0], lfoOut[1], randomOut };
+
+    for (int d = 0; d < numDestinations; ++d) {
+        if (!destinationActive[d])
+            continue;
+
+        float* out = arena.getPointer(ScratchArena::modulationBuffer, d);
+        bool first = true;
+
+        for (int r = 0; r < numRoutings; ++r) {
+            const auto& routing = routings[(size_t) r];
+
+            if (routing.destination != d)
+                continue;
+
+            if (first)
+                juce::FloatVectorOperations::copyWithMultiply(out, sources[routing.source], routing.depth, numSamples);
+            else
+                juce::FloatVectorOperations::addWithMultiply(out, sources[routing.source], routing.depth, numSamples);
+
+            first = false;
+        }
+    }
+}
+
+float ModulationMatrix::getLfoIncrement(const Lfo& lfo) const {
+    return (float) (bpm / 60.0 / lfo.beatsPerCycle / sampleRate);
+}
+
+void ModulationMatrix::renderLfo(Lfo& lfo, float* out, int numSamples) {
+    const float increment = getLfoIncrement(lfo);
+    const float phase = lfo.phase;
+
+    // Phase ramp first, then shape it, both loops vectorize
+    for (int i = 0; i < numSamples; ++i) {
+        const float p = phase + (float) i * increment;
+        out[i] = p - std::floor(p);
+    }
+
+    switch (lfo.shape)
+    {
+    case LfoShape::sine:
+        // Parabolic sine, within 0.1% of the real thing
+        for (int i = 0; i < numSamples; ++i) {
+            const float x = 2.0f * out[i] - 1.0f;
+            const float y = 4.0f * x * (1.0f - std::abs(x));
+            out[i] = -(0.225f * (y * std::abs(y) - y) + y);
+        }
+        break;
+    case LfoShape::triangle:
+        for (int i = 0; i < numSamples; ++i)
+            out[i] = 1.0f - 4.0f * std::abs(out[i] - 0.5f);
+        break;
+    case LfoShape::saw:
+        for (int i = 0; i < numSamples; ++i)
+            out[i] = 2.0f * out[i] - 1.0f;
+        break;
+    case LfoShape::square:
+        for (int i = 0; i < numSamples; ++i)
+            out[i] = out[i] < 0.5f ? 1.0f : -1.0f;
+        break;
+    }
+
+    const float next = phase + (float) numSamples * increment;
+    lfo.phase = next - std::floor(next);
+}
+
+void ModulationMatrix::renderRandom(float* out, int numSamples) {
+    // Glides from one random value to the next, once per cycle
+    const float increment = randomRate / (float) sampleRate;
+
+    for (int i = 0; i < numSamples; ++i) {
+        out[i] = randomFrom + (randomTo - randomFrom) * randomPhase;
+        randomPhase += increment;
+
+        if (randomPhase >= 1.0f) {
+            randomPhase -= 1.0f;
+            randomFrom = randomTo;
+            randomTo = rng.nextFloat() * 2.0f - 1.0f;
+        }
+    }
+}
@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    ModulationMatrix.h
+    Created: 19 Oct 2026 4:02:37pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <JuceHeader.h>
+#include "ScratchArena.h"
+
+// Routes modulation sources to destinations at block rate.
+//
+// Every block the routed sources are rendered into the arena's source
+// buffers, then each destination with at least one routing gets the sum of
+// its sources times their depths in its modulation buffer. Destinations with
+// no routings are left alone, check isActive() before reading them.
+class ModulationMatrix {
+public:
+	enum Source {
+		envelope,
+		lfo1,
+		lfo2,
+		random,
+		numSources
+	};
+
+	enum Destination {
+		drive,
+		preFilterCutoff,
+		postFilterCutoff,
+		preFilterResonance,
+		postFilterResonance,
+		mix,
+		numDestinations
+	};
+
+	enum class LfoShape {
+		sine,
+		triangle,
+		saw,
+		square
+	};
+
+	static constexpr int numLfos = 2;
+	static constexpr int maxRoutings = 16;
+
+	static_assert(numDestinations <= ScratchArena::numModulationBuffers, "Not enough modulation buffers for every destination");
+	static_assert(numSources - 1 <= ScratchArena::numSourceBuffers, "Not enough source buffers for every source");
+
+	ModulationMatrix();
+
+	void prepare(double sampleRate);
+	void reset();
+
+	// Routings are rebuilt every block, zero depths are ignored
+	void clearRoutings();
+	void addRouting(Source source, Destination destination, float depth);
+
+	// Beats per LFO cycle, e.g. 1.0 for quarter notes
+	void setLfo(int index, double beatsPerCycle, LfoShape shape);
+	void setRandomRate(float hz);
+
+	void setTempo(double bpm);
+
+	// Locks the LFOs to the host's position, in quarter notes
+	void syncToPosition(double ppqPosition);
+
+	// Renders the routed sources and every active destination for one block
+	void process(ScratchArena& arena, const float* envelopeIn, int numSamples);
+
+	bool isActive(Destination destination) const noexcept;
+
+private:
+	struct Routing {
+		Source source;
+		Destination destination;
+		float depth;
+	};
+
+	struct Lfo {
+		double beatsPerCycle = 1.0;
+		LfoShape shape = LfoShape::sine;
+		float phase = 0.0f;
+	};
+
+	float getLfoIncrement(const Lfo& lfo) const;
+	void renderLfo(Lfo& lfo, float* out, int numSamples);
+	void renderRandom(float* out, int numSamples);
+
+	std::array<Routing, maxRoutings> routings;
+	int numRoutings;
+
+	bool sourceUsed[numSources];
+	bool destinationActive[numDestinations];
+
+	std::array<Lfo, numLfos> lfos;
+
+	float randomRate;
+	float randomPhase;
+	float randomFrom;
+	float randomTo;
+	juce::Random rng;
+
+	static constexpr juce::int64 randomSeed = 0x49474e; // "IGN"
+
+	double sampleRate;
+	double bpm;
+};
@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+
+    Oversampler.cpp
+    Created: 19 Oct 2026 5:11:43pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#include "Oversampler.h"
+
+static float dot(const float* a, const float* b, int n) {
+    float sum = 0.0f;
+
+    for (int i = 0; i < n; ++i)
+        sum += a[i] * b[i];
+
+    return sum;
+}
+
+Oversampler::Oversampler()
+    : factor(1) {
+
+}
+
+void Oversampler::prepare(int numChannels) {
+    state.resize((size_t) numChannels);
+
+    for (auto& s : state) {
+        s.up.assign(upLength * 2, 0.0f);
+        s.down.assign(downLength * 2, 0.0f);
+    }
+
+    reset();
+}
+
+void Oversampler::reset() {
+    for (auto& s : state) {
+        std::fill(s.up.begin(), s.up.end(), 0.0f);
+        std::fill(s.down.begin(), s.down.end(), 0.0f);
+        s.upPosition = 0;
+        s.downPosition = 0;
+    }
+}
+
+void Oversampler::setFactor(int newFactor) {
+    jassert(newFactor == 1 || newFactor == 2 || newFactor == 4 || newFactor == 8);
+
+    if (newFactor != factor) {
+        factor = newFactor;
+        reset();
+    }
+}
+
+int Oversampler::getFactor() const noexcept {
+    return factor;
+}
+
+void Oversampler::upsample(int channel, const float* in, int inStride, float* out, int numSamples) {
+    jassert(juce::isPositiveAndBelow(channel, (int) state.size()));
+    auto& s = state[(size_t) channel];
+
+    const auto* filter = factor > 1 ? tables->getOversamplingFilter(factor) : nullptr;
+    const float* phases = filter != nullptr ? filter->upPhases.data() : nullptr;
+
+    for (int i = 0; i < numSamples; ++i) {
+        s.up[(size_t) s.upPosition] = s.up[(size_t) (s.upPosition + upLength)] = in[i * inStride];
+        const float* window = s.up.data() + s.upPosition + 1; // oldest first
+
+        if (phases == nullptr) {
+            // Half of the round trip latency on the way in, held across the group
+            for (int p = 0; p < factor; ++p)
+                out[i * factor + p] = window[upLength - 1 - latency / 2];
+        }
+        else {
+            for (int p = 0; p < factor; ++p)
+                out[i * factor + p] = dot(phases + p * upLength, window, upLength);
+        }
+
+        s.upPosition = s.upPosition + 1 == upLength ? 0 : s.upPosition + 1;
+    }
+}
+
+void Oversampler::downsample(int channel, const float* in, float* out, int outStride, int numSamples) {
+    jassert(juce::isPositiveAndBelow(channel, (int) state.size()));
+    auto& s = state[(size_t) channel];
+
+    const int length = factor * tapsPerPhase + 1;
+    const auto* filter = factor > 1 ? tables->getOversamplingFilter(factor) : nullptr;
+    const float* taps = filter != nullptr ? filter->downTaps.data() : nullptr;
+
+    for (int i = 0; i < numSamples; ++i) {
+        for (int p = 0; p < factor; ++p) {
+            s.down[(size_t) s.downPosition] = s.down[(size_t) (s.downPosition + downLength)] = in[i * factor + p];
+            const float* window = s.down.data() + s.downPosition + 1 + (downLength - length);
+
+            // Only the first phase of each group is kept, the taps are symmetric
+            if (p == 0) {
+                if (taps == nullptr)
+                    out[i * outStride] = window[length - 1 - (latency - latency / 2) * factor];
+                else
+                    out[i * outStride] = dot(taps, window, length);
+            }
+
+            s.downPosition = s.downPosition + 1 == downLength ? 0 : s.downPosition + 1;
+        }
+    }
+}
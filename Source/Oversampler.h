@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    Oversampler.h
+    Created: 19 Oct 2026 5:11:43pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <JuceHeader.h>
+#include "DSPTables.h"
+
+// Polyphase FIR oversampling around the distortion stage.
+//
+// Each factor uses a linear phase Kaiser windowed sinc of factor * tapsPerPhase + 1
+// taps, so the round trip is always exactly tapsPerPhase samples at the base
+// rate. At a factor of 1 it turns into a plain delay of the same length, which
+// keeps the latency identical whichever factor is active. The same delay, with
+// each sample held across its group, stands in while the shared filters are
+// still being built.
+class Oversampler {
+public:
+	static constexpr int tapsPerPhase = 16;
+	static constexpr int maxFactor = 8;
+	static constexpr int latency = tapsPerPhase; // base rate samples, the same at every factor
+
+	Oversampler();
+
+	void prepare(int numChannels);
+	void reset();
+
+	// 1, 2, 4 or 8, changing it resets the filter state
+	void setFactor(int newFactor);
+	int getFactor() const noexcept;
+
+	// numSamples base rate samples in, numSamples * factor out
+	void upsample(int channel, const float* in, int inStride, float* out, int numSamples);
+
+	// numSamples * factor samples in, numSamples base rate samples out
+	void downsample(int channel, const float* in, float* out, int outStride, int numSamples);
+
+private:
+	struct ChannelState {
+		std::vector<float> up;   // base rate history, written twice so a window is always contiguous
+		std::vector<float> down; // oversampled history, the same trick
+		int upPosition = 0;
+		int downPosition = 0;
+	};
+
+	static constexpr int upLength = tapsPerPhase + 1;
+	static constexpr int downLength = maxFactor * tapsPerPhase + 1;
+
+	// The filters themselves are shared with every other instance
+	juce::SharedResourcePointer<DSPTables> tables;
+
+	std::vector<ChannelState> state;
+
+	int factor;
+};
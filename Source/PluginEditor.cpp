@@ -12,10 +12,22 @@
 //==============================================================================
 IngitionAudioProcessorEditor::IngitionAudioProcessorEditor(IngitionAudioProcessor& p)
     : AudioProcessorEditor(&p), audioProcessor(p)
+#if IGNITION_DIAGNOSTICS
+    , loadMeter(p.getStageProfiler())
+#endif
+    , levelMeter(p.getInputMeter(), p.getOutputMeter())
 {
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
+#if IGNITION_DIAGNOSTICS
+    // The load meter goes to the right of everything else
+    addAndMakeVisible(loadMeter);
+    setSize(500 + LoadMeterPanel::preferredWidth, 600);
+#else
     setSize(500, 600);
+#endif
+
+    setLookAndFeel(&knobLookAndFeel.get());
 
     // Pre Filter
     preFilterCutoffSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
@@ -36,6 +48,9 @@ IngitionAudioProcessorEditor::IngitionAudioProcessorEditor(IngitionAudioProcesso
     addAndMakeVisible(preFilterOnButton);
     preFilterOnButtonAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(audioProcessor.apvts, "pre-filter on", preFilterOnButton);
 
+    addAndMakeVisible(preFilterSaturateButton);
+    preFilterSaturateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(audioProcessor.apvts, "pre-filter saturate", preFilterSaturateButton);
+
     // Post Filter
     postFilterCutoffSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
     postFilterCutoffSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
@@ -54,6 +69,9 @@ IngitionAudioProcessorEditor::IngitionAudioProcessorEditor(IngitionAudioProcesso
 
     addAndMakeVisible(postFilterOnButton);
     postFilterOnButtonAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(audioProcessor.apvts, "post-filter on", postFilterOnButton);
+
+    addAndMakeVisible(postFilterSaturateButton);
+    postFilterSaturateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(audioProcessor.apvts, "post-filter saturate", postFilterSaturateButton);
     
 
     // Drive
@@ -72,9 +90,63 @@ IngitionAudioProcessorEditor::IngitionAudioProcessorEditor(IngitionAudioProcesso
     distortionTypeSelector.addItem("Fuzz", 3);
     distortionTypeSelector.addItem("Rectify", 4);
     distortionTypeSelector.addItem("Downsample", 5);
+    distortionTypeSelector.addItem("Diode", 6);
     addAndMakeVisible(distortionTypeSelector);
     distortionTypeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.apvts, "distortion type", distortionTypeSelector);
 
+    downsampleRateSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
+    downsampleRateSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+    addAndMakeVisible(downsampleRateSlider);
+    downsampleRateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "downsample rate", downsampleRateSlider);
+
+    addAndMakeVisible(downsampleBandLimitButton);
+    downsampleBandLimitAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(audioProcessor.apvts, "downsample band limit", downsampleBandLimitButton);
+
+    stereoModeSelector.addItem("Left/Right", 1);
+    stereoModeSelector.addItem("Mid/Side", 2);
+    addAndMakeVisible(stereoModeSelector);
+    stereoModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.apvts, "stereo mode", stereoModeSelector);
+
+    renderQualitySelector.addItem("Same as Realtime", 1);
+    renderQualitySelector.addItem("High", 2);
+    renderQualitySelector.addItem("Best", 3);
+    renderQualitySelector.addItem("Alias-Free", 4);
+    addAndMakeVisible(renderQualitySelector);
+    renderQualityAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.apvts, "render quality", renderQualitySelector);
+
+    qualityTierSelector.addItem("Eco", 1);
+    qualityTierSelector.addItem("Standard", 2);
+    qualityTierSelector.addItem("High", 3);
+    addAndMakeVisible(qualityTierSelector);
+    qualityTierAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.apvts, "quality tier", qualityTierSelector);
+    qualityTierSelector.onChange = [this] { updateCpuEstimate(); };
+
+    cpuEstimateLabel.setFont(11.0f);
+    addAndMakeVisible(cpuEstimateLabel);
+    updateCpuEstimate();
+
+    // Cabinet
+    addAndMakeVisible(cabinetOnButton);
+    cabinetOnButtonAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(audioProcessor.apvts, "cabinet on", cabinetOnButton);
+
+    const auto impulseFile = audioProcessor.getCabinetImpulseResponseFile();
+    loadImpulseButton.setButtonText(impulseFile == juce::File() ? "Load IR" : impulseFile.getFileNameWithoutExtension());
+    loadImpulseButton.onClick = [this]
+    {
+        impulseChooser = std::make_unique<juce::FileChooser>("Load cabinet impulse response", juce::File(), "*.wav");
+        impulseChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles, [this](const juce::FileChooser& chooser)
+        {
+            const auto file = chooser.getResult();
+
+            if (file.existsAsFile())
+            {
+                audioProcessor.loadCabinetImpulseResponse(file);
+                loadImpulseButton.setButtonText(file.getFileNameWithoutExtension());
+            }
+        });
+    };
+    addAndMakeVisible(loadImpulseButton);
+
     // Other
     mixSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
     mixSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
@@ -87,70 +159,77 @@ IngitionAudioProcessorEditor::IngitionAudioProcessorEditor(IngitionAudioProcesso
     addAndMakeVisible(gateSlider);
     gateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "gate", gateSlider);
 
+    addAndMakeVisible(levelMeter);
+
 }
 
 IngitionAudioProcessorEditor::~IngitionAudioProcessorEditor()
 {
+    setLookAndFeel(nullptr);
+}
+
+void IngitionAudioProcessorEditor::updateCpuEstimate()
+{
+    // The measuring happens off the message thread, and the editor may be gone by the time it's done
+    juce::Component::SafePointer<IngitionAudioProcessorEditor> editor(this);
+
+    audioProcessor.estimateTierCpuLoad([editor](const IngitionAudioProcessor::TierLoads& loads)
+    {
+        if (editor != nullptr)
+            editor->showCpuEstimate(loads);
+    });
+}
+
+void IngitionAudioProcessorEditor::showCpuEstimate(const IngitionAudioProcessor::TierLoads& loads)
+{
+    static const char* tierNames[] = { "Eco", "Std", "High" };
+
+    const int currentTier = qualityTierSelector.getSelectedItemIndex();
+
+    juce::String text = "CPU:";
+
+    for (int tier = 0; tier < QualitySettings::numTiers; ++tier)
+    {
+        const juce::String estimate = juce::String(tierNames[tier]) + " " + juce::String(loads[(size_t) tier] * 100.0f, 1) + "%";
+        text << "  " << estimate << (tier == currentTier ? "*" : "");
+    }
+
+    cpuEstimateLabel.setText(text, juce::dontSendNotification);
 }
 
 //==============================================================================
 void IngitionAudioProcessorEditor::paint(juce::Graphics& g)
 {
+    IGNITION_TRACE_ZONE("editor paint");
+
     g.fillAll(juce::Colours::darkgrey);
 
-    const float width = getWidth();
     const float height = getHeight();
 
-    // Define the area where the envelope history is drawn
-    const float envelopeAreaHeight = 100.0f;  // Adjust this height based on your layout
-    const juce::Rectangle<float> envelopeBounds(0, height - envelopeAreaHeight, width, envelopeAreaHeight);
+    // Define the area where the envelope history is drawn, the level meters take the rest of the strip
+    const juce::Rectangle<float> envelopeBounds(0, height - envelopeAreaHeight, levelMeterX, envelopeAreaHeight);
 
     // Optional: Fill the background for the envelope area
     g.setColour(juce::Colours::black);
     g.fillRect(envelopeBounds);
 
+    // One min/max bar per pixel, from whichever level of the history fits the zoom
+    audioProcessor.getEnvelopeHistory().read(envelopeSeconds, envelopeRanges.data(), (int) envelopeRanges.size());
 
-    const auto& envelope2History = audioProcessor.getEnvelope2History();
-    const int history2Size = envelope2History.size();
+    g.setColour(juce::Colours::white);
 
-    if (history2Size > 1)
+    for (size_t x = 0; x < envelopeRanges.size(); ++x)
     {
-        g.setColour(juce::Colours::red);
-
-        const float stepX = width / static_cast<float>(history2Size);
-
-        // Draw the envelope history as lines
-        for (int i = 1; i < history2Size; ++i)
-        {
-            const float x1 = (i - 1) * stepX;
-            const float y1 = envelopeBounds.getBottom() - envelope2History[i - 1] * 100.0f; // Adjust scaling factor as needed
-            const float x2 = i * stepX;
-            const float y2 = envelopeBounds.getBottom() - envelope2History[i] * 100.0f;
+        const float top = envelopeBounds.getBottom() - juce::jmin(envelopeRanges[x].max, 1.0f) * envelopeAreaHeight;
+        const float bottom = envelopeBounds.getBottom() - juce::jmin(envelopeRanges[x].min, 1.0f) * envelopeAreaHeight;
 
-            g.drawLine(x1, y1, x2, y2, 2.0f); // Line width of 2.0f
-        }
+        g.fillRect(envelopeBounds.getX() + (float) x, top - 1.0f, 1.0f, bottom - top + 2.0f);
     }
 
-    const auto& envelopeHistory = audioProcessor.getEnvelopeHistory();
-    const int historySize = envelopeHistory.size();
-
-    if (historySize > 1)
-    {
-        g.setColour(juce::Colours::white);
-
-        const float stepX = width / static_cast<float>(historySize);
-
-        // Draw the envelope history as lines
-        for (int i = 1; i < historySize; ++i)
-        {
-            const float x1 = (i - 1) * stepX;
-            const float y1 = envelopeBounds.getBottom() - envelopeHistory[i - 1] * 100.0f; // Adjust scaling factor as needed
-            const float x2 = i * stepX;
-            const float y2 = envelopeBounds.getBottom() - envelopeHistory[i] * 100.0f;
-
-            g.drawLine(x1, y1, x2, y2, 2.0f); // Line width of 2.0f
-        }
-    }
+    g.setColour(juce::Colours::grey);
+    g.setFont(12.0f);
+    g.drawText(juce::String(envelopeSeconds, envelopeSeconds < 1.0 ? 2 : 1) + " s", envelopeBounds.reduced(4.0f, 2.0f),
+               juce::Justification::topRight);
 
     // DRAW THE DISTORTION WAVETABLE!!!
     const auto waveshapePoints = audioProcessor.getWaveshape();
@@ -177,11 +256,25 @@ void IngitionAudioProcessorEditor::paint(juce::Graphics& g)
 
     // Trigger repaint for the envelope area, in case its being blocked by another component like a dial
     // The repaint request can be called here if necessary, or when the envelope history changes
+#if IGNITION_DIAGNOSTICS
+    numRepaintRequests += 2;
+#endif
+    IGNITION_TRACE_INSTANT("repaint requested");
     repaint(envelopeBounds.toNearestInt()); // Repaint only the area containing the envelope lines
     repaint(Rectangle<int>(wavetableX, wavetableY, wavetableWidth, wavetableHeight)); // Repaint only the area containing the envelope lines
 }
 
 
+void IngitionAudioProcessorEditor::mouseWheelMove(const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel)
+{
+    if (event.position.y < (float) getHeight() - envelopeAreaHeight || event.position.x >= (float) levelMeterX)
+        return;
+
+    // Up zooms in, about a factor of two per notch
+    envelopeSeconds = juce::jlimit(0.05, EnvelopeHistory::historySeconds, envelopeSeconds * std::exp2(-wheel.deltaY * 4.0));
+    repaint();
+}
+
 void IngitionAudioProcessorEditor::resized()
 {
     // Filter
@@ -189,20 +282,42 @@ void IngitionAudioProcessorEditor::resized()
     preFilterResonanceSlider.setBounds(0, 150, 100, 100);
     preFilterCutoffModSlider.setBounds(0, 250, 100, 100);
     preFilterOnButton.setBounds(25, 0, 50, 50);
+    preFilterSaturateButton.setBounds(25, 350, 50, 50);
 
     postFilterCutoffSlider.setBounds(400, 50, 100, 100);
     postFilterResonanceSlider.setBounds(400, 150, 100, 100);
     postFilterCutoffModSlider.setBounds(400, 250, 100, 100);
     postFilterOnButton.setBounds(425, 0, 50, 50);
+    postFilterSaturateButton.setBounds(425, 350, 50, 50);
 
     // Distortion
     driveSlider.setBounds(150, 50, 200, 200);
     driveModSlider.setBounds(200, 250, 100, 100);
     distortionTypeSelector.setBounds(200, 350, 100, 40);
+    downsampleRateSlider.setBounds(200, 400, 100, 100);
+    downsampleBandLimitButton.setBounds(125, 400, 50, 50);
+    stereoModeSelector.setBounds(200, 10, 100, 30);
+    renderQualitySelector.setBounds(300, 10, 100, 30);
+    qualityTierSelector.setBounds(100, 10, 100, 30);
+    cpuEstimateLabel.setBounds(0, 480, 200, 20);
+
+    // Cabinet
+    cabinetOnButton.setBounds(25, 400, 50, 50);
+    loadImpulseButton.setBounds(0, 450, 100, 30);
 
     // Other
     mixSlider.setBounds(400, 400, 100, 100);
 
     // Envelope
     gateSlider.setBounds(300, 400, 100, 100);
+
+    // Meters
+    levelMeter.setBounds(levelMeterX, 500, 200, 100);
+
+    // Sized here so paint() never allocates
+    envelopeRanges.resize((size_t) levelMeterX);
+
+#if IGNITION_DIAGNOSTICS
+    loadMeter.setBounds(500, 0, LoadMeterPanel::preferredWidth, getHeight());
+#endif
 }
@@ -10,6 +10,11 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "Diagnostics.h"
+#include "LoadMeterPanel.h"
+#include "LevelMeterPanel.h"
+#include "KnobLookAndFeel.h"
+#include "TraceRecorder.h"
 
 //==============================================================================
 /**
@@ -24,28 +29,51 @@ public:
     void paint(juce::Graphics&) override;
     void resized() override;
 
+    // Zooms the envelope in and out
+    void mouseWheelMove(const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel) override;
+
+#if IGNITION_DIAGNOSTICS
+    // Repaints paint() has asked for so far, for the paint benchmark
+    int getNumRepaintRequests() const noexcept { return numRepaintRequests; }
+#endif
+
 private:
+    // Measures every tier at the current settings in the background, then
+    // shows them with the one in use marked
+    void updateCpuEstimate();
+    void showCpuEstimate(const IngitionAudioProcessor::TierLoads& loads);
+
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     IngitionAudioProcessor& audioProcessor;
 
+    // Cached knob frames, shared with every other open editor. Declared before
+    // the sliders so it outlives them.
+    juce::SharedResourcePointer<KnobLookAndFeel> knobLookAndFeel;
+
+#if IGNITION_DIAGNOSTICS
+    int numRepaintRequests = 0;
+
+    LoadMeterPanel loadMeter;
+#endif
+
     // Pre Filter
     juce::Slider preFilterCutoffSlider, preFilterResonanceSlider, preFilterCutoffModSlider;
 
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> preFilterCutoffAttachment, preFilterResonanceAttachment, preFilterCutoffModAttachment;
 
-    juce::ToggleButton preFilterOnButton;
+    juce::ToggleButton preFilterOnButton, preFilterSaturateButton;
 
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> preFilterOnButtonAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> preFilterOnButtonAttachment, preFilterSaturateAttachment;
 
     // Post Filter
     juce::Slider postFilterCutoffSlider, postFilterResonanceSlider, postFilterCutoffModSlider;
 
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> postFilterCutoffAttachment, postFilterResonanceAttachment, postFilterCutoffModAttachment;
 
-    juce::ToggleButton postFilterOnButton;
+    juce::ToggleButton postFilterOnButton, postFilterSaturateButton;
 
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> postFilterOnButtonAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> postFilterOnButtonAttachment, postFilterSaturateAttachment;
 
     // Distortion
     juce::Slider driveSlider, driveModSlider; // mixSlide;
@@ -56,6 +84,37 @@ private:
 
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> distortionTypeAttachment;
 
+    juce::Slider downsampleRateSlider;
+
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> downsampleRateAttachment;
+
+    juce::ToggleButton downsampleBandLimitButton;
+
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> downsampleBandLimitAttachment;
+
+    juce::ComboBox stereoModeSelector;
+
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> stereoModeAttachment;
+
+    juce::ComboBox renderQualitySelector;
+
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> renderQualityAttachment;
+
+    juce::ComboBox qualityTierSelector;
+
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> qualityTierAttachment;
+
+    juce::Label cpuEstimateLabel;
+
+    // Cabinet
+    juce::ToggleButton cabinetOnButton;
+
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> cabinetOnButtonAttachment;
+
+    juce::TextButton loadImpulseButton;
+
+    std::unique_ptr<juce::FileChooser> impulseChooser;
+
     // Other
     juce::Slider mixSlider;
 
@@ -65,5 +124,15 @@ private:
 
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> gateAttachment;
 
+    // In/out levels, at the right of the envelope strip along the bottom
+    LevelMeterPanel levelMeter;
+
+    static constexpr int levelMeterX = 300;
+    static constexpr float envelopeAreaHeight = 100.0f;
+
+    // The envelope strip, one min/max per pixel over the last envelopeSeconds
+    std::vector<EnvelopeHistory::Range> envelopeRanges;
+    double envelopeSeconds = 2.0;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(IngitionAudioProcessorEditor)
 };
\ No newline at end of file
@@ -10,6 +10,7 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "Diagnostics.h"
 #include <cmath>
 
 //==============================================================================
@@ -23,9 +24,23 @@ IngitionAudioProcessor::IngitionAudioProcessor()
         .withOutput("Output", juce::AudioChannelSet::stereo(), true)
 #endif
     ), apvts(*this, nullptr, "PARAMETERS", createParameterLayout()),
+    kernels(DSPKernels::getKernels(DSPKernels::selectInstructionSet())),
     distortion(DistortionEngine())
 #endif
 {
+    preFilter.setKernels(kernels);
+    postFilter.setKernels(kernels);
+    distortion.setKernels(kernels);
+    envelopeFollower.setKernels(kernels);
+    inputMeter.setKernels(kernels);
+    outputMeter.setKernels(kernels);
+
+    // Whatever the tier or render quality, the signal is padded out to the
+    // oversampler's latency. Switching tiers mid-playback never makes the host
+    // re-align anything, and the High tier always gets its oversampling.
+    setLatencySamples(Oversampler::latency);
+
+    cacheParameterPointers();
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout IngitionAudioProcessor::createParameterLayout()
@@ -37,17 +52,63 @@ juce::AudioProcessorValueTreeState::ParameterLayout IngitionAudioProcessor::crea
     params.push_back(std::make_unique<juce::AudioParameterFloat>("pre-filter resonance",  "Pre-Filter Resonance",  0.0f, 1.0f, 0.0f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("pre-filter cutoff mod", "Pre-Filter Cutoff Mod", 0.0f, 1.0f, 0.0f));
     params.push_back(std::make_unique<juce::AudioParameterBool>("pre-filter on", "Pre-Filter On", false));
+    params.push_back(std::make_unique<juce::AudioParameterBool>("pre-filter saturate", "Pre-Filter Saturate", false));
 
     // Post Filter
     params.push_back(std::make_unique<juce::AudioParameterFloat>("post-filter cutoff",     "Post-Filter Cutoff",     0.0f, 1.0f, 1.0f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("post-filter resonance",  "Post-Filter Resonance",  0.0f, 1.0f, 0.0f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("post-filter cutoff mod", "Post-Filter Cutoff Mod", 0.0f, 1.0f, 0.0f));
     params.push_back(std::make_unique<juce::AudioParameterBool>("post-filter on", "Post-Filter On", false));
+    params.push_back(std::make_unique<juce::AudioParameterBool>("post-filter saturate", "Post-Filter Saturate", false));
 
     // Distortion
     params.push_back(std::make_unique<juce::AudioParameterFloat>("drive", "Drive", 0.01f, 20.0f, 0.0f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("drive mod", "Drive Mod", 0.0f, 1.0f, 0.0f));
-    params.push_back(std::make_unique<juce::AudioParameterChoice>("distortion type", "Distortion Type", juce::StringArray{ "Hard Clip", "Tube", "Fuzz", "Rectify", "Downsample" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("distortion type", "Distortion Type", juce::StringArray{ "Hard Clip", "Tube", "Fuzz", "Rectify", "Downsample", "Diode" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("downsample rate", "Downsample Rate", juce::NormalisableRange<float>(1.0f, 32.0f, 0.0f, 0.5f), 1.0f));
+    params.push_back(std::make_unique<juce::AudioParameterBool>("downsample band limit", "Downsample Band Limit", false));
+
+    // Mid/Side
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("stereo mode", "Stereo Mode", juce::StringArray{ "Left/Right", "Mid/Side" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("side drive", "Side Drive", 0.01f, 20.0f, 0.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("side pre-filter cutoff",  "Side Pre-Filter Cutoff",  0.0f, 1.0f, 1.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("side post-filter cutoff", "Side Post-Filter Cutoff", 0.0f, 1.0f, 1.0f));
+
+    // Modulation
+    const juce::StringArray lfoRates{ "4 Bars", "2 Bars", "1 Bar", "1/2", "1/4", "1/8", "1/16", "1/32" };
+    const juce::StringArray lfoShapes{ "Sine", "Triangle", "Saw", "Square" };
+
+    for (int i = 1; i <= ModulationMatrix::numLfos; ++i)
+    {
+        const juce::String id = "lfo " + juce::String(i);
+        const juce::String name = "LFO " + juce::String(i);
+
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(id + " rate", name + " Rate", lfoRates, 4));
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(id + " shape", name + " Shape", lfoShapes, 0));
+    }
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("random rate", "Random Rate", juce::NormalisableRange<float>(0.1f, 20.0f, 0.0f, 0.5f), 1.0f));
+
+    // Same order as ModulationMatrix::Source and ModulationMatrix::Destination
+    const juce::StringArray modulationSources{ "Envelope", "LFO 1", "LFO 2", "Random" };
+    const juce::StringArray modulationDestinations{ "Drive", "Pre-Filter Cutoff", "Post-Filter Cutoff", "Pre-Filter Resonance", "Post-Filter Resonance", "Mix" };
+
+    for (int slot = 1; slot <= numModulationSlots; ++slot)
+    {
+        const juce::String id = "mod " + juce::String(slot);
+        const juce::String name = "Mod " + juce::String(slot);
+
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(id + " source", name + " Source", modulationSources, 1));
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(id + " destination", name + " Destination", modulationDestinations, 0));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(id + " depth", name + " Depth", -1.0f, 1.0f, 0.0f));
+    }
+
+    // Cabinet
+    params.push_back(std::make_unique<juce::AudioParameterBool>("cabinet on", "Cabinet On", false));
+
+    // Quality, same order as QualitySettings::forRenderQuality() and QualitySettings::Tier
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("render quality", "Render Quality", juce::StringArray{ "Same as Realtime", "High", "Best", "Alias-Free" }, 1));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("quality tier", "Quality Tier", juce::StringArray{ "Eco", "Standard", "High" }, QualitySettings::standard));
 
     params.push_back(std::make_unique<juce::AudioParameterFloat>("mix", "Mix", 0.0f, 1.0f, 1.0f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("gate", "Gate", 0.0f, 1.0f, 0.0f));
@@ -56,8 +117,170 @@ juce::AudioProcessorValueTreeState::ParameterLayout IngitionAudioProcessor::crea
     return { params.begin(), params.end() };
 }
 
+void IngitionAudioProcessor::cacheParameterPointers()
+{
+    // Looking parameters up by name means building strings, so it's only done once
+    auto cache = [&](int index, const juce::String& id)
+    {
+        parameterPointers[(size_t) index] = apvts.getRawParameterValue(id);
+        jassert(parameterPointers[(size_t) index] != nullptr);
+    };
+
+    cache(Param::preFilterCutoff,     "pre-filter cutoff");
+    cache(Param::preFilterResonance,  "pre-filter resonance");
+    cache(Param::preFilterCutoffMod,  "pre-filter cutoff mod");
+    cache(Param::preFilterOn,         "pre-filter on");
+    cache(Param::preFilterSaturate,   "pre-filter saturate");
+    cache(Param::postFilterCutoff,    "post-filter cutoff");
+    cache(Param::postFilterResonance, "post-filter resonance");
+    cache(Param::postFilterCutoffMod, "post-filter cutoff mod");
+    cache(Param::postFilterOn,        "post-filter on");
+    cache(Param::postFilterSaturate,  "post-filter saturate");
+
+    cache(Param::drive,               "drive");
+    cache(Param::driveMod,            "drive mod");
+    cache(Param::distortionType,      "distortion type");
+    cache(Param::downsampleRate,      "downsample rate");
+    cache(Param::downsampleBandLimit, "downsample band limit");
+
+    cache(Param::stereoMode,           "stereo mode");
+    cache(Param::sideDrive,            "side drive");
+    cache(Param::sidePreFilterCutoff,  "side pre-filter cutoff");
+    cache(Param::sidePostFilterCutoff, "side post-filter cutoff");
+
+    for (int i = 0; i < ModulationMatrix::numLfos; ++i)
+    {
+        const juce::String id = "lfo " + juce::String(i + 1);
+
+        cache(Param::lfoRate + i,  id + " rate");
+        cache(Param::lfoShape + i, id + " shape");
+    }
+
+    cache(Param::randomRate, "random rate");
+
+    for (int slot = 0; slot < numModulationSlots; ++slot)
+    {
+        const juce::String id = "mod " + juce::String(slot + 1);
+
+        cache(Param::modSource + slot,      id + " source");
+        cache(Param::modDestination + slot, id + " destination");
+        cache(Param::modDepth + slot,       id + " depth");
+    }
+
+    cache(Param::cabinetOn,     "cabinet on");
+    cache(Param::renderQuality, "render quality");
+    cache(Param::qualityTier,   "quality tier");
+    cache(Param::mix,           "mix");
+    cache(Param::gate,          "gate");
+}
+
+//==============================================================================
+// Owns the copy it measures, and gives up as soon as a newer request comes in
+class IngitionAudioProcessor::TierEstimateJob : public juce::ThreadPoolJob
+{
+public:
+    TierEstimateJob(IngitionAudioProcessor& ownerIn, int requestIn, std::unique_ptr<IngitionAudioProcessor> probeIn,
+                    double sampleRateIn, std::function<void(const TierLoads&)> onDoneIn)
+        : juce::ThreadPoolJob("Ignition tier estimate"), owner(ownerIn), request(requestIn), probe(std::move(probeIn)),
+          sampleRate(sampleRateIn), onDone(std::move(onDoneIn))
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        TierLoads loads {};
+        const bool measured = measure(loads);
+
+        // The probe goes back to the message thread it was made on to be destroyed.
+        // Its reference to the shared pool may be the last one, and the pool can't
+        // be torn down from its own thread.
+        juce::MessageManager::callAsync([finished = std::shared_ptr<IngitionAudioProcessor>(std::move(probe)), callback = onDone, measured, loads]
+        {
+            if (measured)
+                callback(loads);
+        });
+
+        return jobHasFinished;
+    }
+
+    IngitionAudioProcessor& owner;
+
+private:
+    bool isStale()
+    {
+        return shouldExit() || owner.latestEstimate.load() != request;
+    }
+
+    bool measure(TierLoads& loads)
+    {
+        const int blockSize = 512;
+
+        // 50 ms of noise per run, enough to average over the sub-blocks
+        const int numBlocks = juce::jmax(1, (int) (sampleRate * 0.05) / blockSize);
+        const int numChannels = probe->getTotalNumOutputChannels();
+
+        juce::AudioBuffer<float> noise(numChannels, blockSize), buffer(numChannels, blockSize);
+        juce::MidiBuffer midi;
+        juce::Random random(1);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < blockSize; ++i)
+                noise.setSample(channel, i, random.nextFloat() * 2.0f - 1.0f);
+
+        for (int tier = 0; tier < QualitySettings::numTiers; ++tier)
+        {
+            probe->parameterPointers[Param::qualityTier]->store((float) tier);
+            probe->prepareToPlay(sampleRate, blockSize);
+
+            // Best of three, the quickest run is the one least disturbed by everything else
+            double bestSeconds = std::numeric_limits<double>::max();
+
+            for (int run = 0; run < 3; ++run)
+            {
+                const auto start = juce::Time::getHighResolutionTicks();
+
+                for (int block = 0; block < numBlocks; ++block)
+                {
+                    buffer.makeCopyOf(noise, true);
+                    probe->processBlock(buffer, midi);
+                }
+
+                bestSeconds = juce::jmin(bestSeconds, juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start));
+
+                if (isStale())
+                    return false;
+            }
+
+            loads[(size_t) tier] = (float) (bestSeconds * sampleRate / (double) (numBlocks * blockSize));
+        }
+
+        probe->releaseResources();
+        return true;
+    }
+
+    const int request;
+    std::unique_ptr<IngitionAudioProcessor> probe;
+    const double sampleRate;
+    std::function<void(const TierLoads&)> onDone;
+};
+
 IngitionAudioProcessor::~IngitionAudioProcessor()
 {
+    // Only this instance's estimates, the thread is shared
+    struct OwnedBy : public juce::ThreadPool::JobSelector
+    {
+        explicit OwnedBy(const IngitionAudioProcessor& ownerIn) : owner(ownerIn) {}
+
+        bool isJobSuitable(juce::ThreadPoolJob* job) override
+        {
+            auto* estimate = dynamic_cast<TierEstimateJob*>(job);
+            return estimate != nullptr && &estimate->owner == &owner;
+        }
+
+        const IngitionAudioProcessor& owner;
+    } ownJobs(*this);
+
+    estimateThread->pool.removeAllJobs(true, 5000, &ownJobs);
 }
 
 //==============================================================================
@@ -95,7 +318,11 @@ bool IngitionAudioProcessor::isMidiEffect() const
 
 double IngitionAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // The cabinet rings on for as long as its impulse response
+    if (parameterPointers[Param::cabinetOn]->load() < 0.5f)
+        return 0.0;
+
+    return cabinet.getImpulseResponseSeconds();
 }
 
 int IngitionAudioProcessor::getNumPrograms()
@@ -130,21 +357,55 @@ void IngitionAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBloc
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
     spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = getTotalNumInputChannels();
+    spec.numChannels = juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels());
+
+    // Every intermediate buffer is allocated here, processBlock never allocates.
+    // Sized for the highest factor so the render quality can change at any time,
+    // but never longer than a sub-block however big the host's blocks are.
+    arena.prepare(spec.numChannels, juce::jlimit(1, subBlockSize, samplesPerBlock), Oversampler::maxFactor);
+
+    preFilter.prepare(spec);
+    postFilter.prepare(spec);
+
+    distortion.prepare((int) spec.numChannels);
+
+    oversampler.prepare((int) spec.numChannels);
 
-    preFilter.reset();
-    preFilter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
-    preFilter.setCutoffFrequency(20000.0f);
+    dryDelay.prepare(spec);
+    dryDelay.setMaximumDelayInSamples(Oversampler::latency);
+    dryDelay.setDelay((float) Oversampler::latency);
 
-    postFilter.reset();
-    postFilter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
-    postFilter.setCutoffFrequency(20000.0f);
+    modulation.prepare(sampleRate);
+
+    cabinet.prepare(spec);
+
+    envelopeFollower.setSampleRate(sampleRate);
+
+    inputMeter.prepare(sampleRate, (int) spec.numChannels, arena.getMaxBlockSize());
+    outputMeter.prepare(sampleRate, (int) spec.numChannels, arena.getMaxBlockSize());
+
+#if IGNITION_DIAGNOSTICS
+    profiler.prepare(sampleRate);
+#endif
+
+    // Everything was just reset, so the parameters all go back in
+    parametersApplied = false;
+    readParameters();
+    applyParameters();
+
+    // Opt-in, each prepareToPlay starts a new capture from this freshly reset state
+    const auto captureDirectory = CaptureRecorder::getCaptureDirectory();
+
+    if (captureAllowed && captureDirectory != juce::File())
+        capture.start(captureDirectory.getNonexistentChildFile("Ignition " + juce::Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S"), ".igncap", false),
+                      sampleRate, samplesPerBlock, (int) spec.numChannels, Param::numParameters);
 }
 
 void IngitionAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    capture.stop();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -154,12 +415,11 @@ bool IngitionAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts)
     juce::ignoreUnused(layouts);
     return true;
 #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-        && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any discrete or surround layout, every channel goes through the same chain.
+    // Past stereo the channels are processed in lane groups.
+    const int numOutputChannels = layouts.getMainOutputChannelSet().size();
+
+    if (numOutputChannels < 1 || numOutputChannels > maxChannels)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -173,111 +433,709 @@ bool IngitionAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts)
 }
 #endif
 
-std::vector<float>& IngitionAudioProcessor::getEnvelopeHistory()
+const EnvelopeHistory& IngitionAudioProcessor::getEnvelopeHistory() const
 {
     return envelopeFollower.getEnvelopeHistory();
 }
 
-std::vector<float>& IngitionAudioProcessor::getEnvelope2History()
+std::vector<float> IngitionAudioProcessor::getWaveshape() {
+    IGNITION_TRACE_ZONE("getWaveshape");
+    return distortion.getWaveshape();
+}
+
+void IngitionAudioProcessor::loadCabinetImpulseResponse(const juce::File& file)
 {
-    return envelopeFollower2.getEnvelopeHistory();
+    apvts.state.setProperty("cabinet ir", file.getFullPathName(), nullptr);
+    cabinet.loadImpulseResponse(file);
 }
 
-std::vector<float> IngitionAudioProcessor::getWaveshape() {
-    return distortion.getWaveshape();
+juce::File IngitionAudioProcessor::getCabinetImpulseResponseFile() const
+{
+    return cabinet.getImpulseResponseFile();
+}
+
+size_t IngitionAudioProcessor::getSharedTableSizeInBytes() const
+{
+    return tables->getSizeInBytes();
+}
+
+size_t IngitionAudioProcessor::getScratchSizeInBytes() const
+{
+    return arena.getSizeInBytes();
 }
 
 void IngitionAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
 
+    // Nothing is allocated until prepareToPlay, a host calling before that gets silence
+    if (arena.getMaxBlockSize() <= 0)
+    {
+        buffer.clear();
+        return;
+    }
+
+    IGNITION_TRACE_ZONE("processBlock");
+    IGNITION_PROFILE_BEGIN_BLOCK(profiler);
+
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
+    // Never hand the arena more samples than it was sized for, whatever the
+    // host sends. Parameters are picked up at every sub-block boundary, and
+    // only go through the setters when one of them has actually moved, so a
+    // host calling with a handful of samples at a time doesn't pay for setup
+    // it already did.
+    const int maxSubBlockSize = arena.getMaxBlockSize();
+
+    updatePlayHead();
+
+    bool parametersChanged = readParameters();
+
+    if (capture.isRecording())
+    {
+        CaptureRecorder::BlockHeader block;
+        block.ticks = juce::Time::getHighResolutionTicks();
+        block.bpm = playHeadState.bpm.orFallback(0.0);
+        block.ppq = playHeadState.ppq.orFallback(0.0);
+        block.flags = (playHeadState.bpm.hasValue() ? CaptureRecorder::hasBpm : 0)
+                    | (playHeadState.ppq.hasValue() ? CaptureRecorder::hasPpq : 0)
+                    | (playHeadState.isPlaying ? CaptureRecorder::isPlaying : 0)
+                    | (lastNonRealtime ? CaptureRecorder::nonRealtime : 0)
+                    | (tables->isReady() ? CaptureRecorder::tablesReady : 0);
+
+        capture.beginBlock(block, parameterValues.data(), buffer);
+    }
+
+    for (int start = 0; start < buffer.getNumSamples(); start += maxSubBlockSize)
+    {
+        if (start > 0)
+            parametersChanged = readParameters();
+
+        if (parametersChanged)
+            applyParameters();
+
+        processSubBlock(buffer, start, juce::jmin(maxSubBlockSize, buffer.getNumSamples() - start));
+    }
+
+    if (capture.isRecording())
+        capture.endBlock(buffer);
+
+    IGNITION_PROFILE_END_BLOCK(profiler, buffer.getNumSamples());
+}
+
+int IngitionAudioProcessor::getNumSnapshotParameters()
+{
+    return Param::numParameters;
+}
+
+void IngitionAudioProcessor::setParameterSnapshot(const float* values)
+{
+    for (int i = 0; i < Param::numParameters; ++i)
+        parameterPointers[(size_t) i]->store(values[i]);
+}
+
+void IngitionAudioProcessor::estimateTierCpuLoad(std::function<void(const TierLoads&)> onDone)
+{
+    // Set up here, where the state and the layout can be read safely
+    auto probe = std::make_unique<IngitionAudioProcessor>();
+    probe->captureAllowed = false;
+    probe->setBusesLayout(getBusesLayout());
+    probe->apvts.replaceState(apvts.copyState());
+    probe->cabinet.copyImpulseResponseFrom(cabinet);
+
+    const double sampleRate = lastSampleRate > 0.0f ? (double) lastSampleRate : 48000.0;
+
+    estimateThread->pool.addJob(new TierEstimateJob(*this, ++latestEstimate, std::move(probe), sampleRate, std::move(onDone)), true);
+}
+
+bool IngitionAudioProcessor::readParameters()
+{
+    bool changed = !parametersApplied;
+
+    for (int i = 0; i < Param::numParameters; ++i)
+    {
+        const float value = parameterPointers[(size_t) i]->load(std::memory_order_relaxed);
+
+        if (value != parameterValues[(size_t) i])
+        {
+            parameterValues[(size_t) i] = value;
+            changed = true;
+        }
+    }
+
+    // Switching between playback and an offline render changes the quality too
+    const bool nonRealtime = isNonRealtime();
+
+    if (nonRealtime != lastNonRealtime)
+    {
+        lastNonRealtime = nonRealtime;
+        changed = true;
+    }
+
+    return changed;
+}
+
+void IngitionAudioProcessor::applyParameters()
+{
+    updateQuality();
+    updateModulation();
+
+    envelopeFollower.setGate(parameterValues[Param::gate]);
+
+    preFilter.setSaturating(parameterValues[Param::preFilterSaturate] > 0.5f);
+    postFilter.setSaturating(parameterValues[Param::postFilterSaturate] > 0.5f);
+
+    // Set the distortion parameters, after the quality so the oversampling factor is current
+    distortion.setDistortionAlgorithm((int) parameterValues[Param::distortionType]);
+    distortion.setDrive(parameterValues[Param::drive]);
+    distortion.setDownsampleFactor(parameterValues[Param::downsampleRate] * (float) oversampler.getFactor());
+    distortion.setDownsampleBandLimited(parameterValues[Param::downsampleBandLimit] > 0.5f);
+
+    parametersApplied = true;
+}
+
+void IngitionAudioProcessor::updatePlayHead()
+{
+    // Host tempo and position for the LFOs, once per host block
+    playHeadState = PlayHeadState();
+
+    if (auto* playHead = getPlayHead())
+    {
+        if (auto position = playHead->getPosition())
+        {
+            playHeadState.bpm = position->getBpm();
+            playHeadState.ppq = position->getPpqPosition();
+            playHeadState.isPlaying = position->getIsPlaying();
+        }
+    }
+
+    if (playHeadState.bpm.hasValue())
+        modulation.setTempo(*playHeadState.bpm);
+
+    if (playHeadState.isPlaying && playHeadState.ppq.hasValue())
+        modulation.syncToPosition(*playHeadState.ppq);
+}
+
+void IngitionAudioProcessor::updateQuality()
+{
+    const int pRenderQuality = (int) parameterValues[Param::renderQuality];
+    const int pQualityTier   = (int) parameterValues[Param::qualityTier];
+
+    const auto tierQuality   = QualitySettings::forTier(pQualityTier);
+    const auto renderQuality = QualitySettings::forRenderQuality(pRenderQuality, tierQuality);
+
+    // Playback runs the tier, offline renders can afford more. The latency is
+    // the same either way, so a bounce lines up with what was heard.
+    quality = isNonRealtime() ? renderQuality : tierQuality;
+
+    oversampler.setFactor(quality.oversamplingFactor);
+
+    preFilter.setCoefficientInterval(quality.coefficientInterval);
+    postFilter.setCoefficientInterval(quality.coefficientInterval);
+
+    preFilter.setMaxIterations(quality.filterIterations);
+    postFilter.setMaxIterations(quality.filterIterations);
+
+    envelopeFollower.setDetectorInterval(quality.envelopeInterval);
+
+    distortion.setShaping(quality.shaping);
+    distortion.setSampleRate(lastSampleRate * oversampler.getFactor());
+    distortion.setPolynomialDegree(DistortionEngine::getAliasFreeDegree(oversampler.getFactor()));
+}
+
+void IngitionAudioProcessor::updateModulation()
+{
+    bool pPreFilterOn  = parameterValues[Param::preFilterOn] > 0.5f;
+    bool pPostFilterOn = parameterValues[Param::postFilterOn] > 0.5f;
+
+    static constexpr double lfoBeats[] = { 16.0, 8.0, 4.0, 2.0, 1.0, 0.5, 0.25, 0.125 };
+
+    for (int i = 0; i < ModulationMatrix::numLfos; ++i)
+    {
+        const int rate  = (int) parameterValues[(size_t) (Param::lfoRate + i)];
+        const int shape = (int) parameterValues[(size_t) (Param::lfoShape + i)];
+
+        modulation.setLfo(i, lfoBeats[rate], (ModulationMatrix::LfoShape) shape);
+    }
+
+    modulation.setRandomRate(parameterValues[Param::randomRate]);
+
+    // Routings to a filter that's switched off would only waste time
+    auto isUsed = [&](ModulationMatrix::Destination destination)
+    {
+        if (destination == ModulationMatrix::preFilterCutoff || destination == ModulationMatrix::preFilterResonance)
+            return pPreFilterOn;
+
+        if (destination == ModulationMatrix::postFilterCutoff || destination == ModulationMatrix::postFilterResonance)
+            return pPostFilterOn;
+
+        return true;
+    };
+
+    modulation.clearRoutings();
+
+    // The original envelope amounts are fixed routings
+    modulation.addRouting(ModulationMatrix::envelope, ModulationMatrix::drive, parameterValues[Param::driveMod]);
+
+    if (pPreFilterOn)
+        modulation.addRouting(ModulationMatrix::envelope, ModulationMatrix::preFilterCutoff, parameterValues[Param::preFilterCutoffMod]);
+
+    if (pPostFilterOn)
+        modulation.addRouting(ModulationMatrix::envelope, ModulationMatrix::postFilterCutoff, parameterValues[Param::postFilterCutoffMod]);
+
+    for (int slot = 0; slot < numModulationSlots; ++slot)
+    {
+        const auto source      = (ModulationMatrix::Source) (int) parameterValues[(size_t) (Param::modSource + slot)];
+        const auto destination = (ModulationMatrix::Destination) (int) parameterValues[(size_t) (Param::modDestination + slot)];
+
+        if (isUsed(destination))
+            modulation.addRouting(source, destination, parameterValues[(size_t) (Param::modDepth + slot)]);
+    }
+}
+
+void IngitionAudioProcessor::processSubBlock(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    const int numChannels = juce::jmin(getTotalNumInputChannels(), arena.getNumChannels());
+    const bool oversampling = oversampler.getFactor() > 1;
+
     // Filter parameters
-    float pPreFilterCutoff    = apvts.getRawParameterValue("pre-filter cutoff")->load();
-    float pPreFilterResonance = apvts.getRawParameterValue("pre-filter resonance")->load();
-    float pPreFilterCutoffMod = apvts.getRawParameterValue("pre-filter cutoff mod")->load();
-    bool pPreFilterOn         = apvts.getRawParameterValue("pre-filter on")->load() > 0.5f;
+    float pPreFilterCutoff    = parameterValues[Param::preFilterCutoff];
+    float pPreFilterResonance = parameterValues[Param::preFilterResonance];
+    bool pPreFilterOn         = parameterValues[Param::preFilterOn] > 0.5f;
 
-    float pPostFilterCutoff    = apvts.getRawParameterValue("post-filter cutoff")->load();
-    float pPostFilterResonance = apvts.getRawParameterValue("post-filter resonance")->load();
-    float pPostFilterCutoffMod = apvts.getRawParameterValue("post-filter cutoff mod")->load();
-    bool pPostFilterOn         = apvts.getRawParameterValue("post-filter on");
+    float pPostFilterCutoff    = parameterValues[Param::postFilterCutoff];
+    float pPostFilterResonance = parameterValues[Param::postFilterResonance];
+    bool pPostFilterOn         = parameterValues[Param::postFilterOn] > 0.5f;
+
+    // Mid/side parameters
+    int   pStereoMode           = (int) parameterValues[Param::stereoMode];
+    float pSideDrive            = parameterValues[Param::sideDrive];
+    float pSidePreFilterCutoff  = parameterValues[Param::sidePreFilterCutoff];
+    float pSidePostFilterCutoff = parameterValues[Param::sidePostFilterCutoff];
 
     // Distortion parameters
-    float pDrive          = apvts.getRawParameterValue("drive")->load();
-    float pDriveMod       = apvts.getRawParameterValue("drive mod")->load();
-    int   pDistortionType = apvts.getRawParameterValue("distortion type")->load();
+    float pDrive = parameterValues[Param::drive];
 
-    // Other parameters
-    float pMix = apvts.getRawParameterValue("mix")->load();
+    // Cabinet parameters
+    bool pCabinetOn = parameterValues[Param::cabinetOn] > 0.5f;
 
-    // Envelope parameters
-    float pGate = apvts.getRawParameterValue("gate")->load();
+    // Other parameters
+    float pMix = parameterValues[Param::mix];
 
-    preFilter.setResonance(juce::jmap(pPreFilterResonance, 0.707f, 4.0f));
-    postFilter.setResonance(juce::jmap(pPostFilterResonance, 0.707f, 4.0f));
     float preFilterCutoff  = juce::jmap(pPreFilterCutoff, 200.0f, 20000.0f);
     float postFilterCutoff = juce::jmap(pPostFilterCutoff, 200.0f, 20000.0f);
+    float sidePreFilterCutoff  = juce::jmap(pSidePreFilterCutoff, 200.0f, 20000.0f);
+    float sidePostFilterCutoff = juce::jmap(pSidePostFilterCutoff, 200.0f, 20000.0f);
 
     const float maxCutoff = 0.45f * lastSampleRate;
 
-    envelopeFollower.setSampleRate(lastSampleRate);
-    envelopeFollower2.setSampleRate(lastSampleRate);
-    envelopeFollower.setGate(pGate);
+    // Mid/side runs both channels as interleaved frames, so it needs exactly two
+    const bool midSide = pStereoMode == 1 && numChannels == 2;
+
+    // Without oversampling, and with a curve that keeps no state of its own, the channels go
+    // through both filters and the curve in one pass. The latency is padded on afterwards.
+    // The chain only has the linear filters. Stereo only takes it with both filters on, where
+    // two recursions side by side in each pass make up for the empty lanes. Otherwise mono
+    // and stereo measured faster in separate passes, with the curve vectorised over time.
+    DSPKernels::ChainSettings chain;
+    const bool saturatingFilter = (pPreFilterOn && preFilter.isSaturating()) || (pPostFilterOn && postFilter.isSaturating());
+    const bool fusedChain = !midSide && !oversampling && !saturatingFilter
+                         && (numChannels > 2 || (numChannels == 2 && pPreFilterOn && pPostFilterOn))
+                         && distortion.getChainShaper(chain.shaper);
+
+    // Past stereo the channels are packed into lane groups, one channel per SIMD lane,
+    // and the filters and curves run a whole group at once. The last group may be short.
+    const bool grouped = numChannels > 2 || fusedChain;
+    const int laneGroupSize = kernels.laneGroupSize;
+    const int numLaneGroups = grouped ? (numChannels + laneGroupSize - 1) / laneGroupSize : 0;
+
+    auto laneGroupWidth = [&](int group) { return juce::jmin(laneGroupSize, numChannels - group * laneGroupSize); };
+
+    float* frames      = arena.getPointer(ScratchArena::interleavedBuffer, 0);
+    float* frameValues = arena.getPointer(ScratchArena::interleavedBuffer, 1); // per lane cutoff, then drive
+    float* frameG      = arena.getPointer(ScratchArena::interleavedBuffer, 2);
+    float* frameH      = arena.getPointer(ScratchArena::interleavedBuffer, 3);
+
+    //=============// CLEAN SIGNAL //=============//
+    IGNITION_PROFILE_STAGE(profiler, envelope);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const float* input = buffer.getReadPointer(channel, startSample);
+
+        juce::FloatVectorOperations::copy(arena.getPointer(ScratchArena::dryBuffer, channel), input, numSamples);
+
+        if (!midSide && !grouped)
+            juce::FloatVectorOperations::copy(arena.getPointer(ScratchArena::wetBuffer, channel), input, numSamples);
+    }
+
+    // Packing takes the place of the wet copy too, unpacked again before the cabinet
+    for (int group = 0; group < numLaneGroups; ++group)
+        kernels.packLanes(arena.getArrayOfPointers(ScratchArena::dryBuffer) + group * laneGroupSize, laneGroupWidth(group),
+                          arena.getPointer(ScratchArena::laneBuffer, group), numSamples);
+
+    // Encoding takes the place of the wet copy
+    if (midSide)
+        kernels.encodeMidSide(buffer.getReadPointer(0, startSample), buffer.getReadPointer(1, startSample), frames, numSamples);
+
+    // One envelope for all channels, so every channel sees the same modulation
+    float* envelope = arena.getPointer(ScratchArena::envelopeBuffer);
+    envelopeFollower.processBlock(arena.getArrayOfPointers(ScratchArena::dryBuffer), numChannels, envelope, numSamples);
 
-    // Set the distortion parameters
-    distortion.setDistortionAlgorithm(pDistortionType);
-    distortion.setDrive(pDrive);
+    inputMeter.process(arena.getArrayOfPointers(ScratchArena::dryBuffer), numChannels, numSamples);
 
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+    // The envelope follows the input as it is, only the mix needs the delayed dry signal
+    for (int channel = 0; channel < numChannels; ++channel)
     {
-        auto* channelData = buffer.getWritePointer(channel);
+        float* dry = arena.getPointer(ScratchArena::dryBuffer, channel);
 
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+        for (int i = 0; i < numSamples; ++i)
         {
-            //=============// CLEAN SIGNAL //=============//
-            float drySignal = channelData[sample]; // Clean signal
+            dryDelay.pushSample(channel, dry[i]);
+            dry[i] = dryDelay.popSample(channel);
+        }
+    }
 
-            float wetSignal = drySignal; // The signal that affects will be applied to
+    //=============// MODULATION //===============//
+    IGNITION_PROFILE_STAGE(profiler, modulation);
 
-            float envDry = envelopeFollower.process(wetSignal); // Update the envelope based on the current sample
+    modulation.process(arena, envelope, numSamples);
 
-            //=======// PRE-DISTORTION FILTERING //=======//
-            if (pPreFilterOn)
-            {
-                const float modulatedPreFilterCutoff = std::min(preFilterCutoff + (20000.0f * envDry * pPreFilterCutoffMod), maxCutoff);
-                preFilter.setCutoffFrequency(modulatedPreFilterCutoff);
+    auto modulationFor = [&](ModulationMatrix::Destination destination) -> float*
+    {
+        return modulation.isActive(destination) ? arena.getPointer(ScratchArena::modulationBuffer, destination) : nullptr;
+    };
 
-                wetSignal = preFilter.processSample(channel, wetSignal);
-            }
+    float* g = arena.getPointer(ScratchArena::coefficientBuffer, 0);
+    float* h = arena.getPointer(ScratchArena::coefficientBuffer, 1);
+
+    // The fused chain needs both filters' coefficients at once
+    float* postG = fusedChain ? arena.getPointer(ScratchArena::coefficientBuffer, 2) : g;
+    float* postH = fusedChain ? arena.getPointer(ScratchArena::coefficientBuffer, 3) : h;
+
+    // Resonance is modulated once per sub-block, cutoff once per sample
+    auto prepareResonance = [&](StateVariableFilter& filter, float resonance, ModulationMatrix::Destination resonanceDestination)
+    {
+        if (const float* resonanceMod = modulationFor(resonanceDestination))
+            resonance = juce::jlimit(0.0f, 1.0f, resonance + resonanceMod[0]);
+
+        filter.setResonance(juce::jmap(resonance, 0.707f, 4.0f));
+    };
+
+    // Returns whether the cutoff is modulated
+    auto prepareFilter = [&](StateVariableFilter& filter, float* filterG, float* filterH, float baseCutoff, float resonance,
+                             ModulationMatrix::Destination cutoffDestination, ModulationMatrix::Destination resonanceDestination)
+    {
+        prepareResonance(filter, resonance, resonanceDestination);
+
+        if (float* cutoff = modulationFor(cutoffDestination))
+        {
+            juce::FloatVectorOperations::multiply(cutoff, 20000.0f, numSamples);
+            juce::FloatVectorOperations::add(cutoff, baseCutoff, numSamples);
+            juce::FloatVectorOperations::clip(cutoff, cutoff, 20.0f, maxCutoff, numSamples);
+
+            filter.computeCoefficients(cutoff, filterG, filterH, numSamples);
+            return true;
+        }
+
+        // Same cutoff for the whole sub-block
+        filter.computeCoefficients(juce::jmin(baseCutoff, maxCutoff), filterG, filterH, numSamples);
+
+        return false;
+    };
+
+    // Mid and side cutoffs go in their own lanes, g and h are free to hold them first
+    auto prepareFilterMidSide = [&](StateVariableFilter& filter, float midCutoff, float sideCutoff, float resonance,
+                                    ModulationMatrix::Destination cutoffDestination, ModulationMatrix::Destination resonanceDestination)
+    {
+        prepareResonance(filter, resonance, resonanceDestination);
+
+        if (const float* cutoffMod = modulationFor(cutoffDestination))
+        {
+            juce::FloatVectorOperations::copyWithMultiply(g, cutoffMod, 20000.0f, numSamples);
+            juce::FloatVectorOperations::copy(h, g, numSamples);
+            juce::FloatVectorOperations::add(g, midCutoff, numSamples);
+            juce::FloatVectorOperations::add(h, sideCutoff, numSamples);
+        }
+        else
+        {
+            juce::FloatVectorOperations::fill(g, midCutoff, numSamples);
+            juce::FloatVectorOperations::fill(h, sideCutoff, numSamples);
+        }
+
+        juce::FloatVectorOperations::clip(g, g, 20.0f, maxCutoff, numSamples);
+        juce::FloatVectorOperations::clip(h, h, 20.0f, maxCutoff, numSamples);
+
+        kernels.interleave(g, h, frameValues, numSamples);
+        filter.computeCoefficients(frameValues, frameG, frameH, numSamples, 2);
+    };
+
+    //=======// PRE-DISTORTION FILTERING //=======//
+    IGNITION_PROFILE_STAGE(profiler, preFilter);
+
+    if (pPreFilterOn && midSide)
+    {
+        prepareFilterMidSide(preFilter, preFilterCutoff, sidePreFilterCutoff, pPreFilterResonance,
+                             ModulationMatrix::preFilterCutoff, ModulationMatrix::preFilterResonance);
+
+        preFilter.processMidSide(frames, frameG, frameH, numSamples);
+    }
+    else if (pPreFilterOn)
+    {
+        const bool cutoffModulated = prepareFilter(preFilter, g, h, preFilterCutoff, pPreFilterResonance,
+                                                   ModulationMatrix::preFilterCutoff, ModulationMatrix::preFilterResonance);
+
+        // The fused chain runs it along with the curve
+        if (fusedChain)
+        {
+            chain.preFilter = true;
+            chain.modulated = cutoffModulated;
+        }
+        else if (grouped)
+        {
+            for (int group = 0; group < numLaneGroups; ++group)
+                preFilter.processLanes(group * laneGroupSize, arena.getPointer(ScratchArena::laneBuffer, group), g, h, numSamples);
+        }
+        else
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
+                preFilter.process(channel, arena.getPointer(ScratchArena::wetBuffer, channel), g, h, numSamples);
+        }
+    }
+
+    //==============// DISTORTION //==============//
+    IGNITION_PROFILE_STAGE(profiler, distortion);
+
+    float* drive = arena.getPointer(ScratchArena::modulationBuffer, ModulationMatrix::drive);
+
+    if (modulation.isActive(ModulationMatrix::drive))
+    {
+        distortion.setModulation(drive[numSamples - 1]); // For the waveshape display
+        distortion.computeDrive(drive, drive, numSamples);
+    }
+    else
+    {
+        distortion.setModulation(0.0f);
+        juce::FloatVectorOperations::fill(drive, distortion.getDrive(), numSamples);
+    }
+
+    // At a factor of 1 the oversampler is only the padding, the curves run at the
+    // base rate and the result goes through it afterwards. Lanes are channels,
+    // or mid and side.
+    auto padLane = [&](int lane, float* data, int stride)
+    {
+        float* padded = arena.getPointer(ScratchArena::oversampledBuffer, lane);
+
+        oversampler.upsample(lane, data, stride, padded, numSamples);
+        oversampler.downsample(lane, padded, data, stride, numSamples);
+    };
+
+    auto distortOversampled = [&](int lane, float* data, const float* laneDrive, int stride)
+    {
+        const int factor = oversampler.getFactor();
+        float* upsampled = arena.getPointer(ScratchArena::oversampledBuffer, lane);
+        float* upsampledDrive = arena.getPointer(ScratchArena::oversampledBuffer, arena.getNumChannels());
 
-            //==============// DISTORTION //==============//
-            distortion.setModulation(envDry * pDriveMod); // Set the modulation
+        // Drive holds across each group of oversampled samples
+        for (int i = 0; i < numSamples; ++i)
+            juce::FloatVectorOperations::fill(upsampledDrive + i * factor, laneDrive[i * stride], factor);
+
+        oversampler.upsample(lane, data, stride, upsampled, numSamples);
+        distortion.processBlock(lane, upsampled, upsampledDrive, numSamples * factor);
+        oversampler.downsample(lane, upsampled, data, stride, numSamples);
+    };
+
+    if (fusedChain)
+    {
+        // The post-filter's coefficients have to be ready before the chain runs
+        if (pPostFilterOn)
+        {
+            chain.postFilter = true;
+            chain.modulated = prepareFilter(postFilter, postG, postH, postFilterCutoff, pPostFilterResonance,
+                                            ModulationMatrix::postFilterCutoff, ModulationMatrix::postFilterResonance) || chain.modulated;
+        }
 
-            wetSignal = distortion.processSample(wetSignal); // Distort signal
+        chain.modulated = chain.modulated || modulation.isActive(ModulationMatrix::drive);
+        chain.preG = g;
+        chain.preH = h;
+        chain.preR2 = preFilter.getR2();
+        chain.postG = postG;
+        chain.postH = postH;
+        chain.postR2 = postFilter.getR2();
+        chain.drive = drive;
 
-            //=======// POST-DISTORTION FILTERING //======//
-            if (pPostFilterOn)
+        for (int group = 0; group < numLaneGroups; ++group)
+        {
+            chain.preState = preFilter.getLaneStates(group * laneGroupSize);
+            chain.postState = postFilter.getLaneStates(group * laneGroupSize);
+
+            float* groupFrames = arena.getPointer(ScratchArena::laneBuffer, group);
+            kernels.chainLanes(chain, groupFrames, numSamples);
+
+            for (int lane = 0; lane < laneGroupWidth(group); ++lane)
+                padLane(group * laneGroupSize + lane, groupFrames + lane, laneGroupSize);
+        }
+    }
+    else if (midSide)
+    {
+        // Side gets the same modulation on top of its own drive
+        juce::FloatVectorOperations::copy(g, drive, numSamples);
+        juce::FloatVectorOperations::add(g, pSideDrive - pDrive, numSamples);
+        juce::FloatVectorOperations::clip(g, g, DistortionEngine::minDrive, DistortionEngine::maxDrive, numSamples);
+
+        kernels.interleave(drive, g, frameValues, numSamples);
+
+        if (oversampling)
+        {
+            distortOversampled(0, frames, frameValues, 2);
+            distortOversampled(1, frames + 1, frameValues + 1, 2);
+        }
+        else
+        {
+            distortion.processMidSide(frames, frameValues, numSamples);
+            padLane(0, frames, 2);
+            padLane(1, frames + 1, 2);
+        }
+    }
+    else if (grouped)
+    {
+        // Every lane gets the same drive, the envelope is linked
+        const float* drivePointers[DSPKernels::maxLaneGroupSize];
+        std::fill(std::begin(drivePointers), std::end(drivePointers), drive);
+
+        float* driveFrames = arena.getPointer(ScratchArena::laneBuffer, numLaneGroups);
+        kernels.packLanes(drivePointers, laneGroupSize, driveFrames, numSamples);
+
+        for (int group = 0; group < numLaneGroups; ++group)
+        {
+            float* groupFrames = arena.getPointer(ScratchArena::laneBuffer, group);
+            const int firstChannel = group * laneGroupSize;
+
+            if (oversampling)
+            {
+                for (int lane = 0; lane < laneGroupWidth(group); ++lane)
+                    distortOversampled(firstChannel + lane, groupFrames + lane, driveFrames + lane, laneGroupSize);
+            }
+            else
             {
-                const float modulatedPostFilterCutoff = std::min(postFilterCutoff + (20000.0f * envDry * pPostFilterCutoffMod), maxCutoff);
-                postFilter.setCutoffFrequency(modulatedPostFilterCutoff);
+                distortion.processLanes(groupFrames, driveFrames, firstChannel, laneGroupWidth(group), numSamples);
 
-                wetSignal = postFilter.processSample(channel, wetSignal);
+                for (int lane = 0; lane < laneGroupWidth(group); ++lane)
+                    padLane(firstChannel + lane, groupFrames + lane, laneGroupSize);
             }
+        }
+    }
+    else
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            float* wet = arena.getPointer(ScratchArena::wetBuffer, channel);
 
-            //==============// DRY-WET MIX //=============//
-            float mixSignal = juce::jmap(pMix, drySignal, wetSignal); // Dry-wet mixed signal
+            if (oversampling)
+            {
+                distortOversampled(channel, wet, drive, 1);
+            }
+            else
+            {
+                distortion.processBlock(channel, wet, drive, numSamples);
+                padLane(channel, wet, 1);
+            }
+        }
+    }
 
-            channelData[sample] = mixSignal; // Example: Apply simple gain reduction
+    //=======// POST-DISTORTION FILTERING //======//
+    IGNITION_PROFILE_STAGE(profiler, postFilter);
 
-            envelopeFollower2.process(mixSignal);
+    if (pPostFilterOn && midSide)
+    {
+        prepareFilterMidSide(postFilter, postFilterCutoff, sidePostFilterCutoff, pPostFilterResonance,
+                             ModulationMatrix::postFilterCutoff, ModulationMatrix::postFilterResonance);
+
+        postFilter.processMidSide(frames, frameG, frameH, numSamples);
+    }
+    else if (pPostFilterOn && !fusedChain)
+    {
+        prepareFilter(postFilter, postG, postH, postFilterCutoff, pPostFilterResonance,
+                      ModulationMatrix::postFilterCutoff, ModulationMatrix::postFilterResonance);
+
+        if (grouped)
+        {
+            for (int group = 0; group < numLaneGroups; ++group)
+                postFilter.processLanes(group * laneGroupSize, arena.getPointer(ScratchArena::laneBuffer, group), postG, postH, numSamples);
+        }
+        else
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
+                postFilter.process(channel, arena.getPointer(ScratchArena::wetBuffer, channel), postG, postH, numSamples);
+        }
+    }
+
+    // Back to a buffer per channel for the cabinet and the mix
+    for (int group = 0; group < numLaneGroups; ++group)
+        kernels.unpackLanes(arena.getPointer(ScratchArena::laneBuffer, group), arena.getArrayOfPointers(ScratchArena::wetBuffer) + group * laneGroupSize,
+                            laneGroupWidth(group), numSamples);
+
+    //================// CABINET //===============//
+    IGNITION_PROFILE_STAGE(profiler, cabinet);
+
+    if (pCabinetOn)
+    {
+        // The cabinet works on left/right, so decode before it instead of in the mix
+        if (midSide)
+            kernels.decodeMidSide(frames, arena.getPointer(ScratchArena::wetBuffer, 0), arena.getPointer(ScratchArena::wetBuffer, 1), numSamples);
+
+        cabinet.setNonRealtime(isNonRealtime());
+        cabinet.process(arena.getArrayOfPointers(ScratchArena::wetBuffer), numChannels, numSamples);
+    }
+
+    //==============// DRY-WET MIX //=============//
+    IGNITION_PROFILE_STAGE(profiler, mix);
+
+    float* mix = modulationFor(ModulationMatrix::mix);
+
+    if (mix != nullptr)
+    {
+        juce::FloatVectorOperations::add(mix, pMix, numSamples);
+        juce::FloatVectorOperations::clip(mix, mix, 0.0f, 1.0f, numSamples);
+    }
+
+    if (midSide && !pCabinetOn)
+    {
+        if (mix == nullptr)
+        {
+            mix = arena.getPointer(ScratchArena::modulationBuffer, ModulationMatrix::mix);
+            juce::FloatVectorOperations::fill(mix, pMix, numSamples);
+        }
+
+        kernels.decodeMidSideMix(frames, arena.getPointer(ScratchArena::dryBuffer, 0), arena.getPointer(ScratchArena::dryBuffer, 1),
+                                 arena.getPointer(ScratchArena::wetBuffer, 0), arena.getPointer(ScratchArena::wetBuffer, 1), mix, numSamples);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            juce::FloatVectorOperations::copy(buffer.getWritePointer(channel, startSample), arena.getPointer(ScratchArena::wetBuffer, channel), numSamples);
+    }
+    else
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            float* wet = arena.getPointer(ScratchArena::wetBuffer, channel);
+            const float* dry = arena.getPointer(ScratchArena::dryBuffer, channel);
+
+            if (mix != nullptr)
+                kernels.mixModulated(wet, dry, mix, numSamples);
+            else
+                kernels.mix(wet, dry, pMix, numSamples);
+
+            juce::FloatVectorOperations::copy(buffer.getWritePointer(channel, startSample), wet, numSamples);
         }
     }
+
+    outputMeter.process(arena.getArrayOfPointers(ScratchArena::wetBuffer), numChannels, numSamples);
+
+    IGNITION_PROFILE_END(profiler);
 }
 
 //==============================================================================
@@ -294,20 +1152,33 @@ juce::AudioProcessorEditor* IngitionAudioProcessor::createEditor()
 //==============================================================================
 void IngitionAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    if (auto xml = apvts.copyState().createXml())
+        copyXmlToBinary(*xml, destData);
 }
 
 void IngitionAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    auto xml = getXmlFromBinary(data, sizeInBytes);
+
+    if (xml == nullptr || ! xml->hasTagName(apvts.state.getType()))
+        return;
+
+    apvts.replaceState(juce::ValueTree::fromXml(*xml));
+
+    // The cabinet IR lives outside the parameters, so reload it from its path
+    const juce::File impulseFile(apvts.state.getProperty("cabinet ir").toString());
+
+    if (impulseFile.existsAsFile())
+        cabinet.loadImpulseResponse(impulseFile);
 }
 
 //==============================================================================
 // This creates new instances of the plugin..
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
+#if IGNITION_DIAGNOSTICS
+    Diagnostics::runRequestedBenchmarks();
+#endif
+
     return new IngitionAudioProcessor();
 }
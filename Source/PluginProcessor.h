@@ -11,7 +11,19 @@
 #include <JuceHeader.h>
 #include <juce_dsp/juce_dsp.h>
 #include "EnvelopeFollower.h"
+#include "LevelMeter.h"
 #include "DistortionEngine.h"
+#include "ScratchArena.h"
+#include "StateVariableFilter.h"
+#include "DSPKernels.h"
+#include "CabinetConvolver.h"
+#include "ModulationMatrix.h"
+#include "Oversampler.h"
+#include "QualitySettings.h"
+#include "DSPTables.h"
+#include "CaptureRecorder.h"
+#include "StageProfiler.h"
+#include "TraceRecorder.h"
 
 using namespace juce;
 //==============================================================================
@@ -31,9 +43,37 @@ public:
 #ifndef JucePlugin_PreferredChannelConfigurations
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 #endif
-    std::vector<float>& getEnvelopeHistory();
-    std::vector<float>& getEnvelope2History();
+    const EnvelopeHistory& getEnvelopeHistory() const;
     std::vector<float> getWaveshape();
+
+    // Levels before and after the effect, for the editor's meters
+    const LevelMeter& getInputMeter() const noexcept { return inputMeter; }
+    const LevelMeter& getOutputMeter() const noexcept { return outputMeter; }
+
+    void loadCabinetImpulseResponse(const juce::File& file);
+    juce::File getCabinetImpulseResponseFile() const;
+
+    // Memory held by the tables every instance shares, and by this instance's buffers
+    size_t getSharedTableSizeInBytes() const;
+    size_t getScratchSizeInBytes() const;
+
+    // For replaying captures: the number of values in a parameter snapshot,
+    // and storing one as if the host had set every parameter
+    static int getNumSnapshotParameters();
+    void setParameterSnapshot(const float* values);
+
+    // Message thread. Runs a copy of this instance, with its layout, settings and
+    // cabinet IR, at every quality tier on a background thread, and hands onDone
+    // the fraction of one core each would take back on the message thread. A newer
+    // request drops an older one that hasn't finished, without calling it.
+    using TierLoads = std::array<float, QualitySettings::numTiers>;
+    void estimateTierCpuLoad(std::function<void(const TierLoads&)> onDone);
+
+#if IGNITION_DIAGNOSTICS
+    // Per stage load for the editor's diagnostics panel
+    StageProfiler& getStageProfiler() noexcept { return profiler; }
+#endif
+
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
     //==============================================================================
@@ -64,13 +104,107 @@ public:
 private:
     //==============================================================================
     AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+
+    void cacheParameterPointers();
+    bool readParameters();
+    void applyParameters();
+
+    void updatePlayHead();
+    void updateModulation();
+    void updateQuality();
+
+    class TierEstimateJob;
+
+    // Every instance's estimates take turns on one thread
+    struct EstimateThread
+    {
+        juce::ThreadPool pool { 1 };
+    };
+
+    void processSubBlock(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    static constexpr int numModulationSlots = 4;
+
+    // Host buffers are cut into sub-blocks of at most this many samples, small
+    // enough that every working buffer stays in L1
+    static constexpr int subBlockSize = 128;
+
+    // Any layout up to this many channels, 7.1.4 plus a few spare
+    static constexpr int maxChannels = 16;
+
+    // Every parameter the audio thread reads, in the order of parameterPointers
+    struct Param
+    {
+        enum
+        {
+            preFilterCutoff, preFilterResonance, preFilterCutoffMod, preFilterOn, preFilterSaturate,
+            postFilterCutoff, postFilterResonance, postFilterCutoffMod, postFilterOn, postFilterSaturate,
+            drive, driveMod, distortionType, downsampleRate, downsampleBandLimit,
+            stereoMode, sideDrive, sidePreFilterCutoff, sidePostFilterCutoff,
+            lfoRate,                                         // one per LFO
+            lfoShape = lfoRate + ModulationMatrix::numLfos,  // one per LFO
+            randomRate = lfoShape + ModulationMatrix::numLfos,
+            modSource,                                       // one per slot
+            modDestination = modSource + numModulationSlots, // one per slot
+            modDepth = modDestination + numModulationSlots,  // one per slot
+            cabinetOn = modDepth + numModulationSlots,
+            renderQuality, qualityTier, mix, gate,
+            numParameters
+        };
+    };
+
+    std::array<std::atomic<float>*, Param::numParameters> parameterPointers;
+
+    // What the current sub-block runs with, only re-applied when something changes
+    std::array<float, Param::numParameters> parameterValues {};
+    bool lastNonRealtime = false;
+    bool parametersApplied = false;
+
+    // Host tempo and position as of the current block
+    struct PlayHeadState
+    {
+        juce::Optional<double> bpm, ppq;
+        bool isPlaying = false;
+    };
+
+    PlayHeadState playHeadState;
+
     float lastSampleRate;
 
-    dsp::StateVariableTPTFilter<float> preFilter, postFilter;
+    QualitySettings quality;
+
+    juce::SharedResourcePointer<DSPTables> tables;
+
+    ScratchArena arena;
+
+    const DSPKernels::KernelTable& kernels;
+
+    StateVariableFilter preFilter, postFilter;
 
     DistortionEngine distortion;
 
-    EnvelopeFollower envelopeFollower, envelopeFollower2;
+    Oversampler oversampler;
+
+    // Keeps the dry signal lined up with the oversampled wet signal
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> dryDelay;
+
+    EnvelopeFollower envelopeFollower;
+
+    LevelMeter inputMeter, outputMeter;
+
+    ModulationMatrix modulation;
+
+    CabinetConvolver cabinet;
+
+    CaptureRecorder capture;
+    bool captureAllowed = true; // off for the copies estimateTierCpuLoad() runs
+
+    juce::SharedResourcePointer<EstimateThread> estimateThread;
+    std::atomic<int> latestEstimate { 0 };
+
+#if IGNITION_DIAGNOSTICS
+    StageProfiler profiler;
+#endif
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(IngitionAudioProcessor)
 };
@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    QualitySettings.h
+    Created: 19 Oct 2026 5:40:02pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DistortionEngine.h"
+
+// How much work the signal chain does. Playback runs the quality tier the
+// instance is set to, offline renders run whatever the "render quality"
+// parameter picks.
+struct QualitySettings {
+	int oversamplingFactor = 1;   // around the distortion stage, 1, 2, 4 or 8
+	int coefficientInterval = 8;  // samples between filter coefficient updates
+	int envelopeInterval = 1;     // samples between envelope detector steps
+	DistortionEngine::Shaping shaping = DistortionEngine::Shaping::approximate;
+	int filterIterations = 4;     // Newton steps per sample at most, for the saturating filters
+
+	// Same order as the "quality tier" choices
+	enum Tier { eco, standard, high, numTiers };
+
+	static QualitySettings forTier(int tier) {
+		switch (tier)
+		{
+		case eco:
+			// For hundreds of tracks: table lookups, control rate filters and envelope
+			return { 1, 32, 8, DistortionEngine::Shaping::lookupTable, 2 };
+		case high:
+			// For the master bus
+			return { 2, 1, 1, DistortionEngine::Shaping::antiderivative, 8 };
+		default:
+			return {};
+		}
+	}
+
+	// Same order as the "render quality" choices. The antiderivative stays out
+	// of renders, its half sample delay would make the bounce not null against
+	// the dry signal, so Same as Realtime swaps it for the exact curves.
+	// Alias-Free trades the exact curves for polynomial fits with no harmonics
+	// past what the oversampling can take.
+	static QualitySettings forRenderQuality(int choice, const QualitySettings& tierSettings) {
+		switch (choice)
+		{
+		case 1:
+			return { 4, 1, 1, DistortionEngine::Shaping::exact, 8 };  // High
+		case 2:
+			return { 8, 1, 1, DistortionEngine::Shaping::exact, 8 };  // Best
+		case 3:
+			return { 8, 1, 1, DistortionEngine::Shaping::polynomial, 8 }; // Alias-Free
+		default:
+		{
+			auto settings = tierSettings;                             // Same as Realtime
+
+			if (settings.shaping == DistortionEngine::Shaping::antiderivative)
+				settings.shaping = DistortionEngine::Shaping::exact;
+
+			return settings;
+		}
+		}
+	}
+};
@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    ScratchArena.cpp
+    Created: 19 Oct 2026 10:12:04am
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#include "ScratchArena.h"
+
+ScratchArena::ScratchArena() {
+
+}
+
+size_t ScratchArena::alignedLength(size_t numFloats) noexcept {
+    const size_t floatsPerLine = alignment / sizeof(float);
+    return (numFloats + floatsPerLine - 1) / floatsPerLine * floatsPerLine;
+}
+
+void ScratchArena::prepare(int newNumChannels, int newMaxBlockSize, int newOversamplingFactor) {
+    numChannels = juce::jmax(1, newNumChannels);
+    maxBlockSize = juce::jmax(1, newMaxBlockSize);
+    oversamplingFactor = juce::jmax(1, newOversamplingFactor);
+
+    const size_t blockStride = alignedLength((size_t) maxBlockSize);
+    const size_t interleavedStride = alignedLength((size_t) maxBlockSize * 2);
+    const size_t oversampledStride = alignedLength((size_t) maxBlockSize * (size_t) oversamplingFactor);
+    const size_t laneStride = alignedLength((size_t) maxBlockSize * DSPKernels::maxLaneGroupSize);
+
+    // Enough groups for the narrowest lanes the kernels come in
+    const int numLaneBuffers = (numChannels + 3) / 4 + 1;
+
+    const int counts[numBufferIds] = { numChannels, numChannels, 1, numSourceBuffers, numModulationBuffers, 4, numInterleavedBuffers, numChannels + 1, numLaneBuffers };
+    const size_t strides[numBufferIds] = { blockStride, blockStride, blockStride, blockStride, blockStride, blockStride, interleavedStride, oversampledStride, laneStride };
+
+    size_t offset = 0;
+
+    for (int i = 0; i < numBufferIds; ++i)
+    {
+        regions[i].offset = offset;
+        regions[i].stride = strides[i];
+        regions[i].count = counts[i];
+        offset += strides[i] * (size_t) counts[i];
+    }
+
+    // Only reallocate when the layout actually grew
+    if (offset > totalFloats || base == nullptr)
+    {
+        storage.allocate(offset * sizeof(float) + alignment, true);
+
+        auto address = reinterpret_cast<uintptr_t>(storage.get());
+        address = (address + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        base = reinterpret_cast<float*>(address);
+        totalFloats = offset;
+    }
+
+    juce::FloatVectorOperations::clear(base, (int) totalFloats);
+
+    for (int i = 0; i < numBufferIds; ++i)
+    {
+        pointers[i].resize((size_t) regions[i].count);
+
+        for (int j = 0; j < regions[i].count; ++j)
+            pointers[i][(size_t) j] = getPointer((BufferId) i, j);
+    }
+}
+
+float* ScratchArena::getPointer(BufferId id, int index) const noexcept {
+    jassert(base != nullptr);
+    jassert(index >= 0 && index < regions[id].count);
+
+    return base + regions[id].offset + regions[id].stride * (size_t) index;
+}
+
+float* const* ScratchArena::getArrayOfPointers(BufferId id) const noexcept {
+    return pointers[id].data();
+}
+
+int ScratchArena::getNumChannels() const noexcept {
+    return numChannels;
+}
+
+int ScratchArena::getMaxBlockSize() const noexcept {
+    return maxBlockSize;
+}
+
+int ScratchArena::getOversamplingFactor() const noexcept {
+    return oversamplingFactor;
+}
+
+size_t ScratchArena::getSizeInBytes() const noexcept {
+    return totalFloats * sizeof(float);
+}
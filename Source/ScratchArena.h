@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    ScratchArena.h
+    Created: 19 Oct 2026 10:12:04am
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <JuceHeader.h>
+#include "DSPKernels.h"
+
+// Owns every intermediate buffer the processor needs in one contiguous,
+// cache-line aligned allocation. It is sized in prepare() and never
+// reallocates on the audio thread.
+class ScratchArena {
+public:
+	enum BufferId {
+		dryBuffer,          // copy of the input, one per channel
+		wetBuffer,          // the signal effects are applied to, one per channel
+		envelopeBuffer,     // linked envelope, one per block
+		sourceBuffer,       // rendered modulation sources, numSourceBuffers per block
+		modulationBuffer,   // one per modulation destination, numModulationBuffers per block
+		coefficientBuffer,  // per sample filter coefficients, g and h, then g and h for the post-filter
+		interleavedBuffer,  // two channel frames for mid/side, numInterleavedBuffers of 2 * maxBlockSize
+		oversampledBuffer,  // one per channel plus one for the drive, maxBlockSize * oversamplingFactor long
+		laneBuffer,         // channels packed into lane groups of frames, one per group plus one for the drive
+		numBufferIds
+	};
+
+	static constexpr int numSourceBuffers = 3; // the envelope has its own buffer
+	static constexpr int numModulationBuffers = 6;
+	static constexpr int numInterleavedBuffers = 4;
+	static constexpr int alignment = 64; // bytes, one cache line
+
+	ScratchArena();
+
+	void prepare(int numChannels, int maxBlockSize, int oversamplingFactor);
+
+	float* getPointer(BufferId id, int index = 0) const noexcept;
+	float* const* getArrayOfPointers(BufferId id) const noexcept;
+
+	int getNumChannels() const noexcept;
+	int getMaxBlockSize() const noexcept;
+	int getOversamplingFactor() const noexcept;
+	size_t getSizeInBytes() const noexcept;
+
+private:
+	struct Region {
+		size_t offset = 0;  // in floats, from the aligned base
+		size_t stride = 0;  // in floats, between consecutive buffers
+		int count = 0;
+	};
+
+	static size_t alignedLength(size_t numFloats) noexcept;
+
+	juce::HeapBlock<char> storage;
+	float* base = nullptr;
+	size_t totalFloats = 0;
+
+	Region regions[numBufferIds];
+	std::vector<float*> pointers[numBufferIds];
+
+	int numChannels = 0;
+	int maxBlockSize = 0;
+	int oversamplingFactor = 1;
+
+	JUCE_DECLARE_NON_COPYABLE(ScratchArena)
+};
@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+
+    StageProfiler.cpp
+    Created: 19 Oct 2026 9:26:51pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#include "StageProfiler.h"
+
+#if IGNITION_DIAGNOSTICS
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+const char* StageProfiler::getStageName(Stage stage) {
+    static const char* const names[] = { "Envelope", "Modulation", "Pre-Filter", "Distortion", "Post-Filter", "Cabinet", "Mix", "Total" };
+    return names[stage];
+}
+
+void StageProfiler::prepare(double newSampleRate) {
+    sampleRate = newSampleRate;
+    counterFrequency = getCounterFrequency();
+    reset();
+}
+
+juce::int64 StageProfiler::readCounter() noexcept {
+#if JUCE_INTEL
+    // A handful of cycles, where the OS timers can take a few hundred
+    return (juce::int64) __rdtsc();
+#else
+    return juce::Time::getHighResolutionTicks();
+#endif
+}
+
+double StageProfiler::getCounterFrequency() {
+#if JUCE_INTEL
+    // The TSC ticks at a fixed rate on anything recent, measured once against
+    // the OS timer over 20 ms
+    static const double frequency = [] {
+        const auto ticksStart = juce::Time::getHighResolutionTicks();
+        const auto counterStart = readCounter();
+
+        while (juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - ticksStart) < 0.02) {}
+
+        const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - ticksStart);
+        return (double) (readCounter() - counterStart) / seconds;
+    }();
+
+    return frequency;
+#else
+    return (double) juce::Time::getHighResolutionTicksPerSecond();
+#endif
+}
+
+void StageProfiler::beginBlock() noexcept {
+    blockCounts.fill(0);
+    currentStage = -1;
+    blockStart = readCounter();
+}
+
+void StageProfiler::beginStage(Stage stage) noexcept {
+    const auto now = readCounter();
+
+    if (currentStage >= 0)
+        blockCounts[(size_t) currentStage] += now - stageStart;
+
+    currentStage = stage;
+    stageStart = now;
+}
+
+void StageProfiler::endStage() noexcept {
+    if (currentStage >= 0)
+        blockCounts[(size_t) currentStage] += readCounter() - stageStart;
+
+    currentStage = -1;
+}
+
+void StageProfiler::endBlock(int numSamples) noexcept {
+    endStage();
+    blockCounts[total] = readCounter() - blockStart;
+
+    if (resetRequested.exchange(false, std::memory_order_acquire))
+        for (auto& histogram : histograms)
+            histogram.clear();
+
+    if (numSamples <= 0)
+        return;
+
+    // What the block took over what it was allowed
+    const double countsPerDeadline = counterFrequency * numSamples / sampleRate;
+
+    for (int stage = 0; stage < numStages; ++stage)
+        histograms[(size_t) stage].add((double) blockCounts[(size_t) stage] / countsPerDeadline);
+}
+
+void StageProfiler::Histogram::add(double load) noexcept {
+    // Only the audio thread writes, so plain loads and stores will do
+    const int bin = load > lowestLoad ? juce::jmin(numBins - 1, (int) (std::log10(load / lowestLoad) * binsPerDecade)) : 0;
+
+    bins[(size_t) bin].store(bins[(size_t) bin].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    sum.store(sum.load(std::memory_order_relaxed) + load, std::memory_order_relaxed);
+    max.store(juce::jmax(max.load(std::memory_order_relaxed), load), std::memory_order_relaxed);
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void StageProfiler::Histogram::clear() noexcept {
+    for (auto& bin : bins)
+        bin.store(0, std::memory_order_relaxed);
+
+    sum.store(0.0, std::memory_order_relaxed);
+    max.store(0.0, std::memory_order_relaxed);
+    count.store(0, std::memory_order_release);
+}
+
+StageProfiler::Summary StageProfiler::getSummary(Stage stage) const {
+    const auto& histogram = histograms[(size_t) stage];
+
+    Summary summary;
+    summary.numBlocks = histogram.count.load(std::memory_order_acquire);
+
+    if (summary.numBlocks == 0)
+        return summary;
+
+    summary.mean = histogram.sum.load(std::memory_order_relaxed) / (double) summary.numBlocks;
+    summary.max = histogram.max.load(std::memory_order_relaxed);
+
+    // Upper edge of the bin the 99th percentile lands in. The audio thread
+    // keeps adding while this reads, so the total is taken from the bins.
+    std::array<juce::uint32, numBins> counts;
+    juce::int64 binTotal = 0;
+
+    for (int bin = 0; bin < numBins; ++bin)
+        binTotal += counts[(size_t) bin] = histogram.bins[(size_t) bin].load(std::memory_order_relaxed);
+
+    juce::int64 below = 0;
+
+    for (int bin = 0; bin < numBins; ++bin) {
+        below += counts[(size_t) bin];
+
+        if (below * 100 >= binTotal * 99) {
+            summary.p99 = juce::jmin(summary.max, lowestLoad * std::pow(10.0, (bin + 1) / (double) binsPerDecade));
+            break;
+        }
+    }
+
+    return summary;
+}
+
+void StageProfiler::reset() noexcept {
+    // Cleared by the audio thread at the end of its next block, so it stays the only writer
+    resetRequested.store(true, std::memory_order_release);
+}
+
+#endif
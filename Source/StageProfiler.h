@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    StageProfiler.h
+    Created: 19 Oct 2026 9:26:51pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <JuceHeader.h>
+#include "Diagnostics.h"
+
+// Per stage DSP load, compiled in only when IGNITION_DIAGNOSTICS is 1.
+//
+// processSubBlock marks where each stage starts with IGNITION_PROFILE_STAGE,
+// and the time up to the next mark goes to that stage. At the end of each
+// host block every stage's total goes into a histogram as a fraction of the
+// block's deadline (its length in real time). The audio thread is the only
+// writer and never waits, the editor reads whenever it likes.
+#if IGNITION_DIAGNOSTICS
+
+class StageProfiler {
+public:
+	enum Stage {
+		envelope,   // input copies, envelope follower, input meter and dry delay
+		modulation,
+		preFilter,
+		distortion, // oversampling included
+		postFilter,
+		cabinet,
+		mix,        // mix, output and the output meter
+		total,      // the whole processBlock, parameter updates included
+		numStages
+	};
+
+	static const char* getStageName(Stage stage);
+
+	// Log spaced from 0.01% of the deadline, 24 bins a decade up to about 20x
+	static constexpr int numBins = 128;
+	static constexpr int binsPerDecade = 24;
+	static constexpr double lowestLoad = 1.0e-4;
+
+	// Fractions of the block deadline, 1.0 is all of it
+	struct Summary {
+		double mean = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+		juce::int64 numBlocks = 0;
+	};
+
+	void prepare(double newSampleRate);
+
+	// Audio thread
+	void beginBlock() noexcept;
+	void beginStage(Stage stage) noexcept;
+	void endStage() noexcept;
+	void endBlock(int numSamples) noexcept;
+
+	// Any thread
+	Summary getSummary(Stage stage) const;
+	void reset() noexcept;
+
+private:
+	static juce::int64 readCounter() noexcept;
+	static double getCounterFrequency();
+
+	struct Histogram {
+		std::array<std::atomic<juce::uint32>, numBins> bins {};
+		std::atomic<double> sum { 0.0 };
+		std::atomic<double> max { 0.0 };
+		std::atomic<juce::int64> count { 0 };
+
+		void add(double load) noexcept;
+		void clear() noexcept;
+	};
+
+	std::array<Histogram, numStages> histograms;
+	std::atomic<bool> resetRequested { false };
+
+	double sampleRate = 44100.0;
+	double counterFrequency = 1.0;
+
+	// Owned by the audio thread
+	std::array<juce::int64, numStages> blockCounts {};
+	juce::int64 blockStart = 0, stageStart = 0;
+	int currentStage = -1;
+};
+
+ #define IGNITION_PROFILE_BEGIN_BLOCK(profiler)           (profiler).beginBlock()
+ #define IGNITION_PROFILE_END_BLOCK(profiler, numSamples) (profiler).endBlock(numSamples)
+ #define IGNITION_PROFILE_STAGE(profiler, stage)          (profiler).beginStage(StageProfiler::stage)
+ #define IGNITION_PROFILE_END(profiler)                   (profiler).endStage()
+
+#else
+
+ #define IGNITION_PROFILE_BEGIN_BLOCK(profiler)
+ #define IGNITION_PROFILE_END_BLOCK(profiler, numSamples)
+ #define IGNITION_PROFILE_STAGE(profiler, stage)
+ #define IGNITION_PROFILE_END(profiler)
+
+#endif
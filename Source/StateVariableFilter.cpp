@@ -0,0 +1,262 @@
+/*
+  ==============================================================================
+
+    StateVariableFilter.cpp
+    Created: 19 Oct 2026 11:40:15am
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#include "StateVariableFilter.h"
+
+// Steps smaller than this count as converged, well under what fastTanh gets right anyway
+static constexpr float newtonTolerance = 1.0e-5f;
+
+StateVariableFilter::StateVariableFilter()
+    : kernels(&DSPKernels::getKernels(DSPKernels::InstructionSet::scalar)), sampleRate(44100.0f), resonance(0.707f), R2(1.0f / 0.707f), coefficientInterval(1),
+      coefficientPhase(0), heldLanes(1), heldG(), heldH(), saturating(false), maxIterations(4) {
+
+}
+
+void StateVariableFilter::prepare(const juce::dsp::ProcessSpec& spec) {
+    sampleRate = (float) spec.sampleRate;
+
+    // Rounded up so the last lane group has state for its empty lanes too
+    const int numLaneGroups = ((int) spec.numChannels + DSPKernels::maxLaneGroupSize - 1) / DSPKernels::maxLaneGroupSize;
+    state.resize((size_t) (numLaneGroups * DSPKernels::maxLaneGroupSize));
+    reset();
+}
+
+void StateVariableFilter::reset() {
+    for (auto& s : state)
+        s = {};
+
+    coefficientPhase = 0;
+}
+
+void StateVariableFilter::setKernels(const DSPKernels::KernelTable& newKernels) {
+    kernels = &newKernels;
+}
+
+void StateVariableFilter::setResonance(float newResonance) {
+    resonance = newResonance;
+    R2 = 1.0f / resonance;
+}
+
+void StateVariableFilter::setCoefficientInterval(int newInterval) {
+    newInterval = juce::jmax(1, newInterval);
+
+    // A new grid starts with an update
+    if (newInterval != coefficientInterval) {
+        coefficientInterval = newInterval;
+        coefficientPhase = 0;
+    }
+}
+
+void StateVariableFilter::setSaturating(bool shouldSaturate) {
+    saturating = shouldSaturate;
+}
+
+bool StateVariableFilter::isSaturating() const {
+    return saturating;
+}
+
+void StateVariableFilter::setMaxIterations(int newMaxIterations) {
+    maxIterations = juce::jmax(1, newMaxIterations);
+}
+
+StateVariableFilter::SolverStats StateVariableFilter::getSolverStats() const {
+    return stats;
+}
+
+void StateVariableFilter::resetSolverStats() {
+    stats = {};
+}
+
+void StateVariableFilter::computeCoefficients(const float* cutoff, float* g, float* h, int numFrames, int numLanes) {
+    jassert(numLanes <= maxCoefficientLanes);
+    const int interval = coefficientInterval;
+
+    if (interval == 1) {
+        kernels->filterCoefficients(cutoff, g, h, R2, sampleRate, numFrames * numLanes);
+        return;
+    }
+
+    // What's held belongs to other lanes after a switch to or from mid/side
+    if (numLanes != heldLanes) {
+        heldLanes = numLanes;
+        coefficientPhase = 0;
+    }
+
+    // Up to the next update on the grid, the last one still holds
+    const int lead = juce::jmin(numFrames, (interval - coefficientPhase) % interval);
+
+    for (int frame = 0; frame < lead; ++frame) {
+        for (int lane = 0; lane < numLanes; ++lane) {
+            g[frame * numLanes + lane] = heldG[lane];
+            h[frame * numLanes + lane] = heldH[lane];
+        }
+    }
+
+    coefficientPhase = (coefficientPhase + numFrames) % interval;
+
+    if (lead == numFrames)
+        return;
+
+    // Gather every update's frame to just past the lead and work those out in one go
+    float* updateG = g + lead * numLanes;
+    float* updateH = h + lead * numLanes;
+    const int numUpdates = (numFrames - lead + interval - 1) / interval;
+
+    for (int k = 0; k < numUpdates; ++k)
+        for (int lane = 0; lane < numLanes; ++lane)
+            updateG[k * numLanes + lane] = cutoff[(lead + k * interval) * numLanes + lane];
+
+    kernels->filterCoefficients(updateG, updateG, updateH, R2, sampleRate, numUpdates * numLanes);
+
+    for (int lane = 0; lane < numLanes; ++lane) {
+        heldG[lane] = updateG[(numUpdates - 1) * numLanes + lane];
+        heldH[lane] = updateH[(numUpdates - 1) * numLanes + lane];
+    }
+
+    // Spread them back out from the end, so nothing is overwritten before it's read
+    for (int k = numUpdates - 1; k >= 0; --k) {
+        const int start = lead + k * interval;
+        const int end = juce::jmin(numFrames, start + interval);
+
+        for (int lane = 0; lane < numLanes; ++lane) {
+            const float gk = updateG[k * numLanes + lane];
+            const float hk = updateH[k * numLanes + lane];
+
+            for (int frame = start; frame < end; ++frame) {
+                g[frame * numLanes + lane] = gk;
+                h[frame * numLanes + lane] = hk;
+            }
+        }
+    }
+}
+
+void StateVariableFilter::computeCoefficients(float cutoff, float* g, float* h, int numFrames) {
+    const int interval = coefficientInterval;
+
+    if (heldLanes != 1) {
+        heldLanes = 1;
+        coefficientPhase = 0;
+    }
+
+    // The cutoff is the same throughout, so only the first update in the block matters
+    const int lead = juce::jmin(numFrames, (interval - coefficientPhase) % interval);
+
+    juce::FloatVectorOperations::fill(g, heldG[0], lead);
+    juce::FloatVectorOperations::fill(h, heldH[0], lead);
+
+    coefficientPhase = (coefficientPhase + numFrames) % interval;
+
+    if (lead == numFrames)
+        return;
+
+    kernels->filterCoefficients(&cutoff, heldG, heldH, R2, sampleRate, 1);
+
+    juce::FloatVectorOperations::fill(g + lead, heldG[0], numFrames - lead);
+    juce::FloatVectorOperations::fill(h + lead, heldH[0], numFrames - lead);
+}
+
+void StateVariableFilter::process(int channel, float* data, const float* g, const float* h, int numSamples) {
+    jassert(channel < (int) state.size());
+
+    if (saturating)
+        processSaturating(state[(size_t) channel], data, 1, g, 1, numSamples);
+    else
+        kernels->filterLowpass(state[(size_t) channel], data, g, h, R2, numSamples);
+}
+
+void StateVariableFilter::processMidSide(float* frames, const float* g, const float* h, int numFrames) {
+    jassert(state.size() >= 2);
+
+    if (saturating) {
+        processSaturating(state[0], frames, 2, g, 2, numFrames);
+        processSaturating(state[1], frames + 1, 2, g + 1, 2, numFrames);
+    }
+    else {
+        kernels->filterLowpassStereo(state.data(), frames, g, h, R2, numFrames);
+    }
+}
+
+void StateVariableFilter::processLanes(int firstChannel, float* frames, const float* g, const float* h, int numFrames) {
+    const int laneGroupSize = kernels->laneGroupSize;
+    jassert(firstChannel + laneGroupSize <= (int) state.size());
+
+    if (saturating) {
+        for (int lane = 0; lane < laneGroupSize; ++lane)
+            processSaturating(state[(size_t) (firstChannel + lane)], frames + lane, laneGroupSize, g, 1, numFrames);
+    }
+    else {
+        kernels->filterLowpassLanes(state.data() + firstChannel, frames, g, h, R2, numFrames);
+    }
+}
+
+void StateVariableFilter::processSaturating(DSPKernels::FilterState& s, float* data, int stride, const float* g, int gStride, int numSamples) {
+    float s1 = s.s1;
+    float s2 = s.s2;
+    float bp = s.bp;
+
+    juce::int64 numIterations = 0;
+    int mostIterations = 0;
+
+    for (int i = 0; i < numSamples; ++i) {
+        const float x = data[i * stride];
+        const float gi = g[i * gStride];
+
+        // With hp = x - R2 * bp - lp and tanh in front of both integrators,
+        //   bp = s1 + g * tanh(hp)
+        //   lp = s2 + g * tanh(bp)
+        // leaves one unknown: f(bp) = bp - s1 - g * tanh(x - R2 * bp - s2 - g * tanh(bp)) = 0.
+        // f' is at least 1, so there's exactly one root, and it lies within g of s1.
+        int iteration = 0;
+
+        while (iteration < maxIterations) {
+            ++iteration;
+
+            const float tbp = DSPKernels::fastTanh(bp);
+            const float thp = DSPKernels::fastTanh(x - R2 * bp - s2 - gi * tbp);
+
+            const float f = bp - s1 - gi * thp;
+            const float slope = 1.0f + gi * (1.0f - thp * thp) * (R2 + gi * (1.0f - tbp * tbp));
+            const float step = f / slope;
+
+            bp = juce::jlimit(s1 - gi, s1 + gi, bp - step);
+
+            if (std::abs(step) < newtonTolerance)
+                break;
+        }
+
+        const float lp = s2 + gi * DSPKernels::fastTanh(bp);
+
+        s1 = 2.0f * bp - s1;
+        s2 = 2.0f * lp - s2;
+
+        data[i * stride] = lp;
+
+        numIterations += iteration;
+        mostIterations = juce::jmax(mostIterations, iteration);
+    }
+
+    s.s1 = s1;
+    s.s2 = s2;
+    s.bp = bp;
+
+    stats.numSamples += numSamples;
+    stats.numIterations += numIterations;
+    stats.mostIterations = juce::jmax(stats.mostIterations, mostIterations);
+}
+
+DSPKernels::FilterState* StateVariableFilter::getLaneStates(int firstChannel) {
+    jassert(firstChannel + kernels->laneGroupSize <= (int) state.size());
+
+    return state.data() + firstChannel;
+}
+
+float StateVariableFilter::getR2() const {
+    return R2;
+}
@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    StateVariableFilter.h
+    Created: 19 Oct 2026 11:40:15am
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <JuceHeader.h>
+#include "DSPKernels.h"
+
+// Lowpass TPT state variable filter, the same topology as
+// juce::dsp::StateVariableTPTFilter, but processed in blocks through the
+// runtime-selected DSP kernels with one cutoff per sample.
+//
+// Saturating mode puts a tanh in front of each integrator, so the feedback loop
+// itself saturates. That leaves no closed form for the zero delay feedback, so
+// each sample is solved with Newton's method instead, starting from the last
+// sample's solution and stopping after maxIterations steps however far it got.
+class StateVariableFilter {
+public:
+	// Newton steps taken, for the benchmarks
+	struct SolverStats {
+		juce::int64 numSamples = 0;
+		juce::int64 numIterations = 0;
+		int mostIterations = 0; // in a single sample
+	};
+
+	StateVariableFilter();
+
+	void prepare(const juce::dsp::ProcessSpec& spec);
+	void reset();
+
+	void setKernels(const DSPKernels::KernelTable& newKernels);
+	void setResonance(float newResonance);
+
+	// Recompute the coefficients every interval samples and hold them in between,
+	// 1 updates every sample. The updates fall on a grid counted from reset(),
+	// wherever the blocks start and end.
+	void setCoefficientInterval(int newInterval);
+
+	void setSaturating(bool shouldSaturate);
+	bool isSaturating() const;
+
+	// Caps the work per sample in saturating mode
+	void setMaxIterations(int newMaxIterations);
+
+	SolverStats getSolverStats() const;
+	void resetSolverStats();
+
+	// Works out per sample coefficients for a block of cutoff frequencies in Hz.
+	// With numLanes > 1 the cutoffs are interleaved frames, e.g. mid/side.
+	void computeCoefficients(const float* cutoff, float* g, float* h, int numFrames, int numLanes = 1);
+
+	// The same for one cutoff held over the whole block
+	void computeCoefficients(float cutoff, float* g, float* h, int numFrames);
+
+	void process(int channel, float* data, const float* g, const float* h, int numSamples);
+
+	// Interleaved mid/side frames, using the state of channels 0 and 1
+	void processMidSide(float* frames, const float* g, const float* h, int numFrames);
+
+	// A group of channels packed by the kernels' packLanes, starting at firstChannel.
+	// Every lane gets the same g and h.
+	void processLanes(int firstChannel, float* frames, const float* g, const float* h, int numFrames);
+
+	// For the kernels' fused chain, which runs the linear recursion itself: the states
+	// of a lane group starting at firstChannel, and the damping term
+	DSPKernels::FilterState* getLaneStates(int firstChannel);
+	float getR2() const;
+
+private:
+	// Saturating mode over every stride-th sample, g is read with gStride
+	void processSaturating(DSPKernels::FilterState& s, float* data, int stride, const float* g, int gStride, int numSamples);
+
+	const DSPKernels::KernelTable* kernels;
+
+	std::vector<DSPKernels::FilterState> state;
+
+	float sampleRate;
+	float resonance;
+	float R2;
+	int coefficientInterval;
+
+	// Frames since the last coefficient update, and what it worked out per lane
+	static constexpr int maxCoefficientLanes = 2;
+	int coefficientPhase;
+	int heldLanes;
+	float heldG[maxCoefficientLanes];
+	float heldH[maxCoefficientLanes];
+
+	bool saturating;
+	int maxIterations;
+	SolverStats stats;
+};
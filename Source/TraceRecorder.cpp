@@ -0,0 +1,168 @@
+/*
+  ==============================================================================
+
+    TraceRecorder.cpp
+    Created: 19 Oct 2026 10:12:40pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#include "TraceRecorder.h"
+
+#if IGNITION_DIAGNOSTICS
+
+#include <mutex>
+
+namespace TraceRecorder {
+
+namespace {
+
+struct Event {
+    const char* name;
+    juce::int64 start;
+    juce::int64 end; // equal to start for instants
+    bool instant;
+};
+
+// Written only by its thread. count goes up forever, the ring keeps the last
+// eventsPerThread, and a reader drops anything that might have been
+// overwritten while it was copying.
+struct ThreadBuffer {
+    juce::String threadName;
+    int index = 0;
+    std::vector<Event> ring;
+    std::atomic<juce::int64> count { 0 };
+
+    void add(const Event& event) noexcept {
+        const auto n = count.load(std::memory_order_relaxed);
+        ring[(size_t) (n % eventsPerThread)] = event;
+        count.store(n + 1, std::memory_order_release);
+    }
+};
+
+struct Registry {
+    std::mutex lock;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    const juce::int64 origin = juce::Time::getHighResolutionTicks();
+};
+
+Registry& getRegistry() {
+    static Registry registry;
+    return registry;
+}
+
+juce::String describeCurrentThread() {
+    if (auto* thread = juce::Thread::getCurrentThread())
+        return thread->getThreadName();
+
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        return "Message thread";
+
+    // Most likely the host's audio thread
+    return "Host thread";
+}
+
+ThreadBuffer& getThreadBuffer() {
+    // Buffers outlive their threads, so a dump still shows threads that are gone
+    thread_local ThreadBuffer* buffer = nullptr;
+
+    if (buffer == nullptr) {
+        auto& registry = getRegistry();
+        auto newBuffer = std::make_unique<ThreadBuffer>();
+        newBuffer->threadName = describeCurrentThread();
+        newBuffer->ring.resize((size_t) eventsPerThread);
+
+        const std::lock_guard<std::mutex> guard(registry.lock);
+        newBuffer->index = (int) registry.buffers.size() + 1;
+        buffer = newBuffer.get();
+        registry.buffers.push_back(std::move(newBuffer));
+    }
+
+    return *buffer;
+}
+
+} // namespace
+
+void addZone(const char* name, juce::int64 startTicks, juce::int64 endTicks) noexcept {
+    getThreadBuffer().add({ name, startTicks, endTicks, false });
+}
+
+void addInstant(const char* name) noexcept {
+    const auto now = juce::Time::getHighResolutionTicks();
+    getThreadBuffer().add({ name, now, now, true });
+}
+
+juce::File getTraceDirectory() {
+    const auto path = juce::SystemStats::getEnvironmentVariable("IGNITION_TRACE", {});
+
+    if (path.isEmpty())
+        return juce::File::getSpecialLocation(juce::File::tempDirectory);
+
+    const auto directory = juce::File::getCurrentWorkingDirectory().getChildFile(path);
+    directory.createDirectory();
+
+    return directory;
+}
+
+bool writeChromeTrace(const juce::File& file) {
+    auto& registry = getRegistry();
+    const double ticksPerMicrosecond = (double) juce::Time::getHighResolutionTicksPerSecond() / 1.0e6;
+
+    auto toMicroseconds = [&](juce::int64 ticks) {
+        return juce::String((double) (ticks - registry.origin) / ticksPerMicrosecond, 3);
+    };
+
+    juce::String json;
+    json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    bool first = true;
+    auto append = [&](const juce::String& event) {
+        json << (first ? "" : ",\n") << event;
+        first = false;
+    };
+
+    const std::lock_guard<std::mutex> guard(registry.lock);
+
+    for (const auto& buffer : registry.buffers) {
+        const juce::String tid(buffer->index);
+
+        append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid
+               + ",\"args\":{\"name\":\"" + buffer->threadName.replace("\"", "'") + "\"}}");
+
+        // Copy first, then throw away whatever the thread lapped in the meantime
+        const auto end = buffer->count.load(std::memory_order_acquire);
+        const auto begin = juce::jmax((juce::int64) 0, end - eventsPerThread);
+
+        std::vector<Event> events;
+        events.reserve((size_t) (end - begin));
+
+        for (auto n = begin; n < end; ++n)
+            events.push_back(buffer->ring[(size_t) (n % eventsPerThread)]);
+
+        // The slot of the event being written right now is the one a lap behind the count
+        const auto oldestIntact = buffer->count.load(std::memory_order_acquire) - eventsPerThread + 1;
+
+        for (auto n = begin; n < end; ++n) {
+            if (n < oldestIntact)
+                continue;
+
+            const auto& event = events[(size_t) (n - begin)];
+            const juce::String common = "{\"name\":\"" + juce::String(event.name) + "\",\"pid\":1,\"tid\":" + tid
+                                      + ",\"ts\":" + toMicroseconds(event.start);
+
+            if (event.instant)
+                append(common + ",\"ph\":\"i\",\"s\":\"t\"}");
+            else
+                append(common + ",\"ph\":\"X\",\"dur\":" + juce::String((double) (event.end - event.start) / ticksPerMicrosecond, 3) + "}");
+        }
+    }
+
+    json << "\n]}\n";
+
+    return file.replaceWithText(json);
+}
+
+} // namespace TraceRecorder
+
+#endif
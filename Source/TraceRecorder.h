@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    TraceRecorder.h
+    Created: 19 Oct 2026 10:12:40pm
+    Author:  blues
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <JuceHeader.h>
+#include "Diagnostics.h"
+
+// Timeline of what every thread was doing, compiled in only when
+// IGNITION_DIAGNOSTICS is 1.
+//
+// IGNITION_TRACE_ZONE("name") records the time from there to the end of the
+// enclosing scope, IGNITION_TRACE_INSTANT("name") a single point. Names must
+// be string literals, only the pointer is kept. Each thread writes into its
+// own ring of the last eventsPerThread events without locks or waiting. The
+// first event on a thread allocates its ring, once. writeChromeTrace() dumps
+// every ring as Chrome trace JSON, for chrome://tracing or ui.perfetto.dev.
+#if IGNITION_DIAGNOSTICS
+
+namespace TraceRecorder {
+	static constexpr int eventsPerThread = 1 << 14;
+
+	void addZone(const char* name, juce::int64 startTicks, juce::int64 endTicks) noexcept;
+	void addInstant(const char* name) noexcept;
+
+	// Any thread. Returns false if the file couldn't be written.
+	bool writeChromeTrace(const juce::File& file);
+
+	// Where "Save trace" puts its files: IGNITION_TRACE if set, otherwise the temp directory
+	juce::File getTraceDirectory();
+
+	class Zone {
+	public:
+		explicit Zone(const char* zoneName) noexcept
+			: name(zoneName), start(juce::Time::getHighResolutionTicks()) {}
+
+		~Zone() { addZone(name, start, juce::Time::getHighResolutionTicks()); }
+
+	private:
+		const char* name;
+		juce::int64 start;
+
+		JUCE_DECLARE_NON_COPYABLE(Zone)
+	};
+}
+
+ #define IGNITION_TRACE_ZONE(name)    TraceRecorder::Zone JUCE_JOIN_MACRO(traceZone, __LINE__) (name)
+ #define IGNITION_TRACE_INSTANT(name) TraceRecorder::addInstant(name)
+
+#else
+
+ #define IGNITION_TRACE_ZONE(name)
+ #define IGNITION_TRACE_INSTANT(name)
+
+#endif